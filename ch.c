@@ -30,6 +30,18 @@ extern ino_t curr_ino;
 #include <sys/statfs.h>
 #endif
 
+#if HAVE_MMAP && HAVE_SYS_MMAN_H
+#include <signal.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS   MAP_ANON
+#endif
+#if defined(MAP_ANONYMOUS) && defined(SIGBUS)
+#define USE_MMAP 1
+#endif
+#endif
+
 typedef POSITION BLOCKNUM;
 
 public int ignore_eoi;
@@ -45,12 +57,19 @@ struct bufnode {
     struct bufnode *hnext, *hprev;
 };
 
-#define LBUFSIZE        8192
+/*
+ * Each file has its own block size, chosen when its filestate is created.
+ * The data of a buffer is allocated along with the buffer itself.
+ */
+#define LBUFSIZE        8192            /* Default block size */
+#define LBUFSIZE_AUTO   (64*1024)       /* Largest block size chosen by itself */
+#define LBUFSIZE_MAX    (1024*1024)     /* Largest block size allowed */
+#define LBUFS_MIN       8               /* Fewest blocks which fit in -b */
 struct buf {
     struct bufnode node;
     BLOCKNUM block;
     unsigned int datasize;
-    unsigned char data[LBUFSIZE];
+    unsigned char *data;
 };
 #define bufnode_buf(bn)  ((struct buf *) bn)
 
@@ -58,10 +77,12 @@ struct buf {
  * The file state is maintained in a filestate structure.
  * A pointer to the filestate is kept in the ifile structure.
  */
-#define BUFHASH_SIZE    1024
+#define BUFHASH_MIN     64
 struct filestate {
     struct bufnode buflist;
-    struct bufnode hashtbl[BUFHASH_SIZE];
+    struct bufnode *hashtbl;    /* Hash chains; doubled as buffers are added */
+    int nhash;                  /* Number of hash chains (a power of 2) */
+    unsigned int bufsize;       /* Block size */
     int file;
     int flags;
     POSITION fpos;
@@ -69,21 +90,48 @@ struct filestate {
     BLOCKNUM block;
     unsigned int offset;
     POSITION fsize;
+#if USE_MMAP
+    unsigned char *mdata;   /* Memory mapping of the file, or NULL */
+    POSITION msize;         /* Number of bytes in the mapping */
+    volatile int mlost;     /* File was truncated under the mapping */
+#endif
+    BLOCKNUM ra_last;       /* Last block read from the file */
+    BLOCKNUM ra_end;        /* Blocks before this have been advised */
+    int ra_window;          /* Blocks to advise ahead; 0 if not in order */
+    POSITION pf_mark;       /* Furthest end of screen seen by ch_prefetch_fd */
+    POSITION pf_window;     /* Bytes of a pipe to read ahead of the screen */
+    long used;              /* When this file was last made current */
 };
 
 #define ch_bufhead      thisfile->buflist.next
 #define ch_buftail      thisfile->buflist.prev
 #define ch_nbufs        thisfile->nbufs
+#define ch_bufsize      thisfile->bufsize
 #define ch_block        thisfile->block
 #define ch_offset       thisfile->offset
 #define ch_fpos         thisfile->fpos
 #define ch_fsize        thisfile->fsize
 #define ch_flags        thisfile->flags
 #define ch_file         thisfile->file
+#define ch_mdata        thisfile->mdata
+#define ch_msize        thisfile->msize
+#define ch_mlost        thisfile->mlost
+
+/*
+ * Read-ahead: while a seekable file is read block after block, the
+ * system is told which blocks will be wanted next, over a window
+ * which doubles each time half of it has been read.
+ * A pipe is read ahead of the screen while waiting for a command,
+ * by twice as much as the screen last moved.
+ */
+#define RA_MIN          4               /* Blocks advised at first */
+#define RA_MAX          256             /* Most blocks advised at once */
+#define PF_MIN          (64*1024)       /* Least read ahead in a pipe */
+#define PF_MAX          (4*1024*1024)   /* Most read ahead in a pipe */
 
 #define END_OF_CHAIN    (&thisfile->buflist)
 #define END_OF_HCHAIN(h) (&thisfile->hashtbl[h])
-#define BUFHASH(blk)    ((blk) & (BUFHASH_SIZE-1))
+#define BUFHASH(blk)    ((blk) & (thisfile->nhash-1))
 
 /*
  * Macros to manipulate the list of buffers in thisfile->buflist.
@@ -126,7 +174,13 @@ struct filestate {
 
 static struct filestate *thisfile;
 static int ch_ungotchar = -1;
-static int maxbufs = -1;
+static int ch_nowait = 0;          /* Return EOI rather than wait for input */
+static POSITION maxbufspace = -1;
+static POSITION allbufspace = 0;   /* Bytes in the buffers of all files */
+static long use_count = 0;
+
+extern int block_size;
+extern int total_bufspace;
 
 extern int autobuf;
 extern int sigs;
@@ -142,6 +196,15 @@ extern char *namelogfile;
 #endif
 
 static int ch_addbuf();
+static int ch_maxbufs();
+static int ch_mayaddbuf();
+static void advise_ahead();
+static void grow_hashtbl();
+#if USE_MMAP
+static void ch_mmap();
+static void ch_munmap();
+static int ch_mvalid();
+#endif
 
 
 /*
@@ -161,6 +224,29 @@ ch_get(VOID_PARAM)
     if (thisfile == NULL)
         return (EOI);
 
+#if USE_MMAP
+    /*
+     * If the file is memory-mapped, get the char directly
+     * from the mapping.  Data past the end of the mapping
+     * (the file has grown since it was mapped) is read into
+     * the buffer pool as usual.  Don't trust the mapping
+     * while following a file, since it may be truncated.
+     * If it is truncated anyway, the read gets a zero page
+     * (see ch_sigbus) and the buffer pool is used instead.
+     */
+    if (ch_mvalid())
+    {
+        pos = (ch_block * ch_bufsize) + ch_offset;
+        if (pos < ch_msize)
+        {
+            n = ch_mdata[pos];
+            if (!ch_mlost)
+                return (n);
+            ch_munmap();
+        }
+    }
+#endif
+
     /*
      * Quick check for the common case where
      * the desired char is in the head buffer.
@@ -205,12 +291,9 @@ ch_get(VOID_PARAM)
         {
             /*
              * There is no empty buffer to use.
-             * Allocate a new buffer if:
-             * 1. We can't seek on this file and -b is not in effect; or
-             * 2. We haven't allocated the max buffers for this file yet.
+             * Maybe allocate a new buffer.
              */
-            if ((autobuf && !(ch_flags & CH_CANSEEK)) ||
-                (maxbufs < 0 || ch_nbufs < maxbufs))
+            if (ch_mayaddbuf())
                 if (ch_addbuf())
                     /*
                      * Allocation failed: turn off autobuf.
@@ -222,11 +305,13 @@ ch_get(VOID_PARAM)
         BUF_HASH_RM(bn); /* Remove from old hash chain. */
         bp->block = ch_block;
         bp->datasize = 0;
+        h = BUFHASH(ch_block); /* The table may have grown. */
         BUF_HASH_INS(bn, h); /* Insert into new hash chain. */
+        advise_ahead(ch_block);
     }
 
     read_more:
-    pos = (ch_block * LBUFSIZE) + bp->datasize;
+    pos = (ch_block * ch_bufsize) + bp->datasize;
     if ((len = ch_length()) != NULL_POSITION && pos >= len)
         /*
          * At end of file.
@@ -267,8 +352,19 @@ ch_get(VOID_PARAM)
         n = 1;
     } else
     {
+        /*
+         * Reading a pipe may have to wait for it,
+         * so let what has been output so far be seen.
+         * A file is read without breaking up the output.
+         */
+        if (!(ch_flags & CH_CANSEEK))
+        {
+            if (ch_nowait && ignore_eoi && !fd_pending(ch_file))
+                return (EOI);
+            flush();
+        }
         n = iread(ch_file, &bp->data[bp->datasize],
-            (unsigned int)(LBUFSIZE - bp->datasize));
+            (unsigned int)(ch_bufsize - bp->datasize));
     }
 
     if (n == READ_INTR)
@@ -303,19 +399,30 @@ ch_get(VOID_PARAM)
     if (n == 0)
     {
         ch_fsize = pos;
+#if USE_MMAP
+        if (ch_mdata != NULL && ch_fsize < ch_msize)
+            /* The file has shrunk; the mapping is no longer valid. */
+            ch_munmap();
+#endif
         if (ignore_eoi)
         {
             /*
              * We are ignoring EOF.
              * Wait a while, then try again.
              */
-            if (!slept)
+            if (ch_nowait)
+                return (EOI);
+            if (!slept && !interactive())
+            {
+                /* Let the output so far be seen while we wait. */
+                flush();
+            } else if (!slept)
             {
                 PARG parg;
                 parg.p_string = wait_message();
                 ierror("%s", &parg);
             }
-            sleep_ms(2); /* Reduce system load */
+            follow_wait(); /* Reduce system load */
             slept = TRUE;
 
 #if HAVE_STAT_INO
@@ -424,7 +531,7 @@ sync_logfile(VOID_PARAM)
     BLOCKNUM block;
     BLOCKNUM nblocks;
 
-    nblocks = (ch_fpos + LBUFSIZE - 1) / LBUFSIZE;
+    nblocks = (ch_fpos + ch_bufsize - 1) / ch_bufsize;
     for (block = 0;  block < nblocks;  block++)
     {
         int wrote = FALSE;
@@ -488,7 +595,7 @@ ch_seek(pos)
     if (pos < ch_zero() || (len != NULL_POSITION && pos > len))
         return (1);
 
-    new_block = pos / LBUFSIZE;
+    new_block = pos / ch_bufsize;
     if (!(ch_flags & CH_CANSEEK) && pos != ch_fpos && !buffered(new_block))
     {
         if (ch_fpos > pos)
@@ -506,7 +613,7 @@ ch_seek(pos)
      * Set read pointer.
      */
     ch_block = new_block;
-    ch_offset = pos % LBUFSIZE;
+    ch_offset = pos % ch_bufsize;
     return (0);
 }
 
@@ -522,7 +629,14 @@ ch_end_seek(VOID_PARAM)
         return (0);
 
     if (ch_flags & CH_CANSEEK)
+    {
         ch_fsize = filesize(ch_file);
+#if USE_MMAP
+        if (ch_mdata != NULL && ch_fsize != NULL_POSITION && ch_fsize < ch_msize)
+            /* The file has shrunk; the mapping is no longer valid. */
+            ch_munmap();
+#endif
+    }
 
     len = ch_length();
     if (len != NULL_POSITION)
@@ -555,7 +669,7 @@ ch_end_buffer_seek(VOID_PARAM)
     FOR_BUFS(bn)
     {
         bp = bufnode_buf(bn);
-        buf_pos = (bp->block * LBUFSIZE) + bp->datasize;
+        buf_pos = (bp->block * ch_bufsize) + bp->datasize;
         if (buf_pos > end_pos)
             end_pos = buf_pos;
     }
@@ -622,7 +736,7 @@ ch_tell(VOID_PARAM)
 {
     if (thisfile == NULL)
         return (NULL_POSITION);
-    return (ch_block * LBUFSIZE) + ch_offset;
+    return (ch_block * ch_bufsize) + ch_offset;
 }
 
 /*
@@ -638,7 +752,7 @@ ch_forw_get(VOID_PARAM)
     c = ch_get();
     if (c == EOI)
         return (EOI);
-    if (ch_offset < LBUFSIZE-1)
+    if (ch_offset < ch_bufsize-1)
         ch_offset++;
     else
     {
@@ -665,11 +779,185 @@ ch_back_get(VOID_PARAM)
         if (!(ch_flags & CH_CANSEEK) && !buffered(ch_block-1))
             return (EOI);
         ch_block--;
-        ch_offset = LBUFSIZE-1;
+        ch_offset = ch_bufsize-1;
     }
     return (ch_get());
 }
 
+/*
+ * Get the run of bytes, contiguous in memory, which starts
+ * at the read pointer.  Set *pp to point to the first byte
+ * and return the number of bytes in the run (0 at end of file).
+ * The read pointer is not moved; use ch_skip for that.
+ * The run is valid only until the next call to a ch_ function.
+ */
+    public int
+ch_forw_span(pp)
+    unsigned char **pp;
+{
+    static unsigned char spanchar;
+    struct buf *bp;
+    POSITION pos;
+    int c;
+
+    if (thisfile == NULL)
+        return (0);
+    c = ch_get();
+    if (c == EOI)
+        return (0);
+    pos = ch_tell();
+#if USE_MMAP
+    if (ch_mvalid() && pos < ch_msize)
+    {
+        *pp = &ch_mdata[pos];
+        if (ch_msize - pos > INT_MAX)
+            return (INT_MAX);
+        return (int) (ch_msize - pos);
+    }
+#endif
+    /*
+     * ch_get has put the buffer holding the block at the head
+     * of the buffer chain.
+     */
+    bp = bufnode_buf(ch_bufhead);
+    if (ch_bufhead != END_OF_CHAIN && bp->block == ch_block && ch_offset < bp->datasize)
+    {
+        *pp = &bp->data[ch_offset];
+        return (int) (bp->datasize - ch_offset);
+    }
+    /*
+     * The char did not come from a buffer (e.g. data lost from a pipe).
+     */
+    spanchar = (unsigned char) c;
+    *pp = &spanchar;
+    return (1);
+}
+
+/*
+ * Get the run of bytes, contiguous in memory, which ends
+ * just before the read pointer.  Set *pp to point to the first byte
+ * and return the number of bytes in the run (0 at beginning of file).
+ * The read pointer is not moved; use ch_skip for that.
+ * The run is valid only until the next call to a ch_ function.
+ */
+    public int
+ch_back_span(pp)
+    unsigned char **pp;
+{
+    static unsigned char spanchar;
+    struct buf *bp;
+    BLOCKNUM save_block;
+    unsigned int save_offset;
+    POSITION pos;
+    int len;
+    int c;
+
+    if (thisfile == NULL)
+        return (0);
+    pos = ch_tell();
+#if USE_MMAP
+    if (ch_mvalid() && pos > 0 && pos <= ch_msize)
+    {
+        if (pos > INT_MAX)
+        {
+            *pp = &ch_mdata[pos - INT_MAX];
+            return (INT_MAX);
+        }
+        *pp = ch_mdata;
+        return (int) pos;
+    }
+#endif
+    save_block = ch_block;
+    save_offset = ch_offset;
+    c = ch_back_get();
+    if (c == EOI)
+    {
+        ch_block = save_block;
+        ch_offset = save_offset;
+        return (0);
+    }
+    /*
+     * ch_get has put the buffer holding the char before the read
+     * pointer at the head of the buffer chain.
+     */
+    bp = bufnode_buf(ch_bufhead);
+    if (ch_bufhead != END_OF_CHAIN && bp->block == ch_block && ch_offset < bp->datasize)
+    {
+        *pp = bp->data;
+        len = (int) ch_offset + 1;
+    } else
+    {
+        spanchar = (unsigned char) c;
+        *pp = &spanchar;
+        len = 1;
+    }
+    ch_block = save_block;
+    ch_offset = save_offset;
+    return (len);
+}
+
+/*
+ * Was the last run returned by ch_forw_span or ch_back_span
+ * (or the mapping returned by ch_mapped) lost?
+ * That happens if the file is truncated while the run is read
+ * from the mapping: the rest of the run reads as zeros (see ch_sigbus).
+ * The caller must then drop what it took from the run and read it
+ * again; the next ch_ call drops the mapping and uses read().
+ */
+    public int
+ch_span_lost(VOID_PARAM)
+{
+#if USE_MMAP
+    return (thisfile != NULL && ch_mdata != NULL && ch_mlost);
+#else
+    return (0);
+#endif
+}
+
+/*
+ * Move the read pointer n bytes forward (or backward, if n is negative).
+ * The caller must stay within data returned by ch_forw_span or ch_back_span.
+ */
+    public void
+ch_skip(n)
+    POSITION n;
+{
+    POSITION pos;
+
+    if (thisfile == NULL)
+        return;
+    pos = ch_tell() + n;
+    ch_block = pos / ch_bufsize;
+    ch_offset = pos % ch_bufsize;
+}
+
+/*
+ * Get the memory mapping of the current file, if it is mapped.
+ * Set *plen to the number of bytes mapped.
+ * The mapping is dropped if the file has been truncated,
+ * since reading the missing part of it would fault.
+ */
+    public unsigned char *
+ch_mapped(plen)
+    POSITION *plen;
+{
+#if USE_MMAP
+    struct stat st;
+
+    if (thisfile != NULL && ch_mvalid())
+    {
+        if (fstat(ch_file, &st) < 0 || (POSITION) st.st_size < ch_msize)
+        {
+            ch_munmap();
+            return (NULL);
+        }
+        *plen = ch_msize;
+        return (ch_mdata);
+    }
+#endif
+    return (NULL);
+}
+
 /*
  * Set max amount of buffer space.
  * bufspace is in units of 1024 bytes.  -1 mean no limit.
@@ -679,13 +967,108 @@ ch_setbufspace(bufspace)
     int bufspace;
 {
     if (bufspace < 0)
-        maxbufs = -1;
+        maxbufspace = -1;
     else
+        maxbufspace = (POSITION) bufspace * 1024;
+}
+
+/*
+ * Return the number of bytes in the buffers of all files.
+ */
+    public POSITION
+ch_memory(VOID_PARAM)
+{
+    return (allbufspace);
+}
+
+/*
+ * Return the max number of buffers for the current file, or -1 if no limit.
+ */
+    static int
+ch_maxbufs(VOID_PARAM)
+{
+    POSITION n;
+
+    if (maxbufspace < 0)
+        return (-1);
+    n = (maxbufspace + ch_bufsize-1) / ch_bufsize;
+    if (n < 1)
+        return (1);
+    return ((int) n);
+}
+
+/*
+ * Free the least recently used buffer of a file which is not current.
+ */
+    static void
+ch_freebuf(fs)
+    struct filestate *fs;
+{
+    struct filestate *save_thisfile = thisfile;
+    struct bufnode *bn;
+
+    thisfile = fs;
+    bn = ch_buftail;
+    BUF_RM(bn);
+    BUF_HASH_RM(bn);
+    free(bufnode_buf(bn));
+    ch_nbufs--;
+    allbufspace -= ch_bufsize;
+    thisfile = save_thisfile;
+}
+
+/*
+ * Make room for another buffer of the current file within the
+ * --total-buffers limit, by freeing the least recently used buffers
+ * of the other files, taking the least recently viewed file first.
+ * A pipe loses the data in the buffers it gives up, as it does under -b,
+ * but it keeps the buffer it was last reading into.
+ * Return FALSE if there is still no room.
+ */
+    static int
+ch_makeroom(VOID_PARAM)
+{
+    POSITION limit;
+    IFILE h;
+    struct filestate *fs;
+    struct filestate *oldest;
+
+    if (total_bufspace < 0 || ch_nbufs == 0)
+        return (TRUE);
+    limit = (POSITION) total_bufspace * 1024;
+    while (allbufspace + ch_bufsize > limit)
     {
-        maxbufs = ((bufspace * 1024) + LBUFSIZE-1) / LBUFSIZE;
-        if (maxbufs < 1)
-            maxbufs = 1;
+        oldest = NULL;
+        for (h = next_ifile(NULL_IFILE);  h != NULL_IFILE;  h = next_ifile(h))
+        {
+            fs = (struct filestate *) get_filestate(h);
+            if (fs == NULL || fs == thisfile ||
+                fs->nbufs <= ((fs->flags & CH_CANSEEK) ? 0 : 1))
+                continue;
+            if (oldest == NULL || fs->used < oldest->used)
+                oldest = fs;
+        }
+        if (oldest == NULL)
+            return (FALSE);
+        ch_freebuf(oldest);
     }
+    return (TRUE);
+}
+
+/*
+ * Should the current file get a new buffer, rather than reuse
+ * its least recently used one?  Allocate a new buffer if:
+ * 1. We can't seek on this file and -b is not in effect; or
+ * 2. We haven't allocated the max buffers for this file yet;
+ * and in either case it fits within --total-buffers.
+ */
+    static int
+ch_mayaddbuf(VOID_PARAM)
+{
+    if (!(autobuf && !(ch_flags & CH_CANSEEK)) &&
+        !(ch_maxbufs() < 0 || ch_nbufs < ch_maxbufs()))
+        return (FALSE);
+    return (ch_makeroom());
 }
 
 /*
@@ -726,8 +1109,8 @@ ch_flush(VOID_PARAM)
      * Seek to a known position: the beginning of the file.
      */
     ch_fpos = 0;
-    ch_block = 0; /* ch_fpos / LBUFSIZE; */
-    ch_offset = 0; /* ch_fpos % LBUFSIZE; */
+    ch_block = 0; /* ch_fpos / ch_bufsize; */
+    ch_offset = 0; /* ch_fpos % ch_bufsize; */
 
 #if HAVE_PROCFS
     /*
@@ -759,6 +1142,183 @@ ch_flush(VOID_PARAM)
          */
         error("seek error to 0", NULL_PARG);
     }
+
+#if USE_MMAP
+    /*
+     * The file may have changed since it was last mapped.
+     */
+    ch_mmap();
+#endif
+}
+
+#if USE_MMAP
+/*
+ * Discard the memory mapping of the current file, if any.
+ */
+    static void
+ch_munmap(VOID_PARAM)
+{
+    if (ch_mdata == NULL)
+        return;
+    (void) munmap((void *) ch_mdata, (size_t) ch_msize);
+    ch_mdata = NULL;
+    ch_msize = 0;
+    ch_mlost = 0;
+}
+
+/*
+ * Is the memory mapping of the current file usable?
+ * A mapping which has lost its file is dropped here.
+ */
+    static int
+ch_mvalid(VOID_PARAM)
+{
+    if (ch_mdata != NULL && ch_mlost)
+        ch_munmap();
+    return (ch_mdata != NULL && !ignore_eoi);
+}
+
+/*
+ * Bus error signal handler.
+ * Reading a page of the mapping beyond the end of the file
+ * (it has been truncated since it was mapped) raises SIGBUS.
+ * Replace the mapping with zero pages, so that the read can
+ * complete, and mark it to be dropped by the next ch_ call.
+ * A second fault is not ours: let it terminate less.
+ */
+    /* ARGSUSED*/
+    static RETSIGTYPE
+ch_sigbus(type)
+    int type;
+{
+    if (thisfile != NULL && ch_mdata != NULL && !ch_mlost &&
+        mmap((void *) ch_mdata, (size_t) ch_msize, PROT_READ,
+            MAP_PRIVATE|MAP_ANONYMOUS|MAP_FIXED, -1, (off_t)0) != MAP_FAILED)
+    {
+        ch_mlost = 1;
+        return;
+    }
+    LSIGNAL(SIGBUS, SIG_DFL);
+}
+
+/*
+ * Map the current file into memory, so ch_get can read it
+ * without going through the buffer pool.
+ * Only regular files which we can seek on are mapped;
+ * pipes, LESSOPEN pipes and the help file use the buffer pool.
+ */
+    static void
+ch_mmap(VOID_PARAM)
+{
+    struct stat st;
+    void *mdata;
+
+    ch_munmap();
+    if (!(ch_flags & CH_CANSEEK) || (ch_flags & (CH_POPENED|CH_HELPFILE|CH_NODATA)))
+        return;
+    if (ch_file < 0 || fstat(ch_file, &st) < 0 || !S_ISREG(st.st_mode))
+        return;
+    if (st.st_size <= 0 || (POSITION) (size_t) st.st_size != (POSITION) st.st_size)
+        return;
+    mdata = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, ch_file, (off_t)0);
+    if (mdata == MAP_FAILED)
+        return;
+    ch_mdata = (unsigned char *) mdata;
+    ch_msize = (POSITION) st.st_size;
+    LSIGNAL(SIGBUS, ch_sigbus);
+}
+#endif
+
+/*
+ * Note that a block is about to be read from the file.
+ * If it follows the last block read, ask the system to start
+ * reading the blocks after it.
+ */
+    static void
+advise_ahead(block)
+    BLOCKNUM block;
+{
+#if HAVE_POSIX_FADVISE && defined(POSIX_FADV_WILLNEED)
+    BLOCKNUM start;
+
+    if ((ch_flags & (CH_CANSEEK|CH_HELPFILE)) != CH_CANSEEK)
+        return;
+    if (block != thisfile->ra_last + 1)
+    {
+        /* Not reading in order; wait until we are. */
+        thisfile->ra_last = block;
+        thisfile->ra_end = block + 1;
+        thisfile->ra_window = 0;
+        return;
+    }
+    thisfile->ra_last = block;
+    if (thisfile->ra_window == 0)
+        thisfile->ra_window = RA_MIN;
+    else if (block + thisfile->ra_window / 2 < thisfile->ra_end)
+        return;
+    else if (thisfile->ra_window < RA_MAX)
+        thisfile->ra_window *= 2;
+    start = thisfile->ra_end;
+    if (start <= block)
+        start = block + 1;
+    thisfile->ra_end = block + 1 + thisfile->ra_window;
+    (void) posix_fadvise(ch_file, (off_t) (start * ch_bufsize),
+        (off_t) ((thisfile->ra_end - start) * ch_bufsize), POSIX_FADV_WILLNEED);
+#endif
+}
+
+/*
+ * Is it worth reading ahead in the current file while waiting
+ * for a command?  That is so for a pipe which has not been read
+ * to its end, until it has been read a window beyond pos,
+ * the end of the screen, as long as no buffer need be given up.
+ * Return the file descriptor to wait for, or -1.
+ */
+    public int
+ch_prefetch_fd(pos)
+    POSITION pos;
+{
+    POSITION moved;
+
+    if (thisfile == NULL || pos == NULL_POSITION || ignore_eoi)
+        return (-1);
+    if ((ch_flags & (CH_CANSEEK|CH_HELPFILE)) || ch_fsize != NULL_POSITION)
+        return (-1);
+    if (pos > thisfile->pf_mark)
+    {
+        /* Read ahead twice as far as the screen has moved. */
+        moved = pos - thisfile->pf_mark;
+        thisfile->pf_mark = pos;
+        thisfile->pf_window = 2 * moved;
+        if (thisfile->pf_window < PF_MIN)
+            thisfile->pf_window = PF_MIN;
+        else if (thisfile->pf_window > PF_MAX)
+            thisfile->pf_window = PF_MAX;
+    }
+    if (ch_fpos >= pos + thisfile->pf_window)
+        return (-1);
+    if (ch_fpos % ch_bufsize == 0 && !buffered(ch_fpos / ch_bufsize) &&
+        ch_buftail != END_OF_CHAIN && bufnode_buf(ch_buftail)->block != -1 &&
+        !ch_mayaddbuf())
+        return (-1);
+    return (ch_file);
+}
+
+/*
+ * Read whatever is waiting in the pipe found by ch_prefetch_fd
+ * into the buffer pool, leaving the read pointer where it was.
+ */
+    public void
+ch_prefetch(VOID_PARAM)
+{
+    BLOCKNUM save_block = ch_block;
+    unsigned int save_offset = ch_offset;
+
+    ch_block = ch_fpos / ch_bufsize;
+    ch_offset = ch_fpos % ch_bufsize;
+    (void) ch_get();
+    ch_block = save_block;
+    ch_offset = save_offset;
 }
 
 /*
@@ -775,33 +1335,102 @@ ch_addbuf(VOID_PARAM)
      * Allocate and initialize a new buffer and link it
      * onto the tail of the buffer list.
      */
-    bp = (struct buf *) calloc(1, sizeof(struct buf));
+    bp = (struct buf *) calloc(1, sizeof(struct buf) + ch_bufsize);
     if (bp == NULL)
         return (1);
+    bp->data = (unsigned char *) (bp + 1);
     ch_nbufs++;
+    allbufspace += ch_bufsize;
     bp->block = -1;
     bn = &bp->node;
 
     BUF_INS_TAIL(bn);
     BUF_HASH_INS(bn, 0);
+    if (ch_nbufs > thisfile->nhash)
+        grow_hashtbl();
     return (0);
 }
 
 /*
- *
+ * Make all the hash chains empty.
  */
     static void
 init_hashtbl(VOID_PARAM)
 {
     int h;
 
-    for (h = 0;  h < BUFHASH_SIZE;  h++)
+    for (h = 0;  h < thisfile->nhash;  h++)
     {
         thisfile->hashtbl[h].hnext = END_OF_HCHAIN(h);
         thisfile->hashtbl[h].hprev = END_OF_HCHAIN(h);
     }
 }
 
+/*
+ * Double the number of hash chains, so that chains stay short
+ * however many buffers a file uses.
+ * If there is no memory for a bigger table, keep the old one.
+ */
+    static void
+grow_hashtbl(VOID_PARAM)
+{
+    struct bufnode *newtbl;
+    struct bufnode *bn;
+    int h;
+
+    newtbl = (struct bufnode *) calloc(2 * thisfile->nhash, sizeof(struct bufnode));
+    if (newtbl == NULL)
+        return;
+    free(thisfile->hashtbl);
+    thisfile->hashtbl = newtbl;
+    thisfile->nhash *= 2;
+    init_hashtbl();
+    FOR_BUFS(bn)
+    {
+        h = BUFHASH(bufnode_buf(bn)->block);
+        BUF_HASH_INS(bn, h);
+    }
+}
+
+/*
+ * Choose the block size for a new file.
+ * With --block-size, use that; otherwise use bigger blocks for
+ * bigger regular files and for media which prefer bigger reads,
+ * but leave room for a few blocks within the -b limit.
+ */
+    static unsigned int
+ch_pickbufsize(f)
+    int f;
+{
+    unsigned int size;
+
+    if (block_size > 0)
+    {
+        if (block_size >= LBUFSIZE_MAX / 1024)
+            return (LBUFSIZE_MAX);
+        return (block_size * 1024);
+    }
+    size = LBUFSIZE;
+#if HAVE_STAT_INO
+    if ((ch_flags & CH_CANSEEK) && !(ch_flags & (CH_POPENED|CH_HELPFILE)))
+    {
+        struct stat st;
+        if (fstat(f, &st) == 0 && S_ISREG(st.st_mode))
+        {
+            /* About a thousand blocks cover the file. */
+            while (size < LBUFSIZE_AUTO && (POSITION) size * 1024 < st.st_size)
+                size *= 2;
+            while (size < LBUFSIZE_AUTO && size < (unsigned int) st.st_blksize)
+                size *= 2;
+        }
+    }
+#endif
+    while (size > LBUFSIZE && maxbufspace >= 0 &&
+           (POSITION) size * LBUFS_MIN > maxbufspace)
+        size /= 2;
+    return (size);
+}
+
 /*
  * Delete all buffers for this file.
  */
@@ -816,6 +1445,7 @@ ch_delbufs(VOID_PARAM)
         BUF_RM(bn);
         free(bufnode_buf(bn));
     }
+    allbufspace -= (POSITION) ch_nbufs * ch_bufsize;
     ch_nbufs = 0;
     init_hashtbl();
 }
@@ -852,6 +1482,17 @@ ch_set_eof(VOID_PARAM)
         ch_fsize = ch_fpos;
 }
 
+/*
+ * Set whether, while ignoring EOF, reading at the end of the
+ * input returns EOI at once instead of waiting for more input.
+ */
+    public void
+ch_set_nowait(nowait)
+    int nowait;
+{
+    ch_nowait = nowait;
+}
+
 
 /*
  * Initialize file state for a new file.
@@ -880,16 +1521,31 @@ ch_init(f, flags)
         thisfile->offset = 0;
         thisfile->file = -1;
         thisfile->fsize = NULL_POSITION;
+#if USE_MMAP
+        thisfile->mdata = NULL;
+        thisfile->msize = 0;
+        thisfile->mlost = 0;
+#endif
+        thisfile->ra_last = -1;
+        thisfile->ra_end = 0;
+        thisfile->ra_window = 0;
+        thisfile->pf_mark = 0;
+        thisfile->pf_window = PF_MIN;
+        thisfile->nhash = BUFHASH_MIN;
+        thisfile->hashtbl = (struct bufnode *)
+                ecalloc(BUFHASH_MIN, sizeof(struct bufnode));
         init_hashtbl();
         /*
          * Try to seek; set CH_CANSEEK if it works.
          */
         if ((flags & CH_CANSEEK) && !seekable(f))
             ch_flags &= ~CH_CANSEEK;
+        thisfile->bufsize = ch_pickbufsize(f);
         set_filestate(curr_ifile, (void *) thisfile);
     }
     if (thisfile->file == -1)
         thisfile->file = f;
+    thisfile->used = ++use_count;
     ch_flush();
 }
 
@@ -904,6 +1560,9 @@ ch_close(VOID_PARAM)
     if (thisfile == NULL)
         return;
 
+#if USE_MMAP
+    ch_munmap();
+#endif
     if ((ch_flags & (CH_CANSEEK|CH_POPENED|CH_HELPFILE)) && !(ch_flags & CH_KEEPOPEN))
     {
         /*
@@ -930,6 +1589,7 @@ ch_close(VOID_PARAM)
         /*
          * We don't even need to keep the filestate structure.
          */
+        free(thisfile->hashtbl);
         free(thisfile);
         thisfile = NULL;
         set_filestate(curr_ifile, (void *) NULL);
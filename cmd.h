@@ -76,6 +76,7 @@
 /* Note "X116" refers to extended (1006) X11 mouse reporting. */
 #define A_X116MOUSE_IN         68
 #define A_CLR_SEARCH           70
+#define A_HIGHLIGHT            71
 
 /* These values must not conflict with any A_* or EC_* value. */
 #define A_INVALID              100
@@ -1473,6 +1473,28 @@ histfile_name(must_exist)
     return (name);
 }
 
+/*
+ * Get the name of a file kept alongside the history file:
+ * the name of the history file with a suffix appended.
+ */
+    public char *
+histfile_sidecar(suffix)
+    char *suffix;
+{
+    char *histname;
+    char *name;
+    int len;
+
+    histname = histfile_name(0);
+    if (histname == NULL)
+        return (NULL);
+    len = (int) (strlen(histname) + strlen(suffix) + 1);
+    name = (char *) ecalloc(len, sizeof(char));
+    SNPRINTF2(name, len, "%s%s", histname, suffix);
+    free(histname);
+    return (name);
+}
+
 /*
  * Read a .lesshst file and call a callback for each line in the file.
  */
@@ -1621,7 +1643,7 @@ write_mlist(ml, f)
 /*
  * Make a temp name in the same directory as filename.
  */
-    static char *
+    public char *
 make_tempname(filename)
     char *filename;
 {
@@ -1689,7 +1711,7 @@ copy_hist(uparam, ml, string)
 /*
  * Make a file readable only by its owner.
  */
-    static void
+    public void
 make_file_private(f)
     FILE *f;
 {
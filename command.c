@@ -63,6 +63,8 @@ extern int shift_count;
 extern int oldbot;
 extern int forw_prompt;
 extern int incr_search;
+extern int new_file;
+extern int scan_ahead;
 #if MSDOS_COMPILER==WIN32C
 extern int utf_mode;
 #endif
@@ -160,6 +162,8 @@ mca_search1(VOID_PARAM)
 #if HILITE_SEARCH
     if (search_type & SRCH_FILTER)
         set_mca(A_FILTER);
+    else if (search_type & SRCH_HIGHLIGHT)
+        set_mca(A_HIGHLIGHT);
     else
 #endif
     if (search_type & SRCH_FORW)
@@ -179,10 +183,14 @@ mca_search1(VOID_PARAM)
         cmd_putstr("Regex-off ");
     if (search_type & SRCH_WRAP)
         cmd_putstr("Wrap ");
+    if (search_type & SRCH_COUNT)
+        cmd_putstr("Count ");
 
 #if HILITE_SEARCH
     if (search_type & SRCH_FILTER)
         cmd_putstr("&/");
+    else if (search_type & SRCH_HIGHLIGHT)
+        cmd_putstr("Highlight/");
     else
 #endif
     if (search_type & SRCH_FORW)
@@ -256,6 +264,9 @@ exec_mca(VOID_PARAM)
         search_type ^= SRCH_NO_MATCH;
         set_filter_pattern(cbuf, search_type);
         break;
+    case A_HIGHLIGHT:
+        set_highlight_pattern((int) number, cbuf, search_type);
+        break;
 #endif
     case A_FIRSTCMD:
         /*
@@ -559,28 +570,33 @@ mca_search_char(c)
     {
     case CONTROL('E'): /* ignore END of file */
     case '*':
-        if (mca != A_FILTER)
+        if (mca != A_FILTER && mca != A_HIGHLIGHT)
             flag = SRCH_PAST_EOF;
         break;
     case CONTROL('F'): /* FIRST file */
     case '@':
-        if (mca != A_FILTER)
+        if (mca != A_FILTER && mca != A_HIGHLIGHT)
             flag = SRCH_FIRST_FILE;
         break;
     case CONTROL('K'): /* KEEP position */
-        if (mca != A_FILTER)
+        if (mca != A_FILTER && mca != A_HIGHLIGHT)
             flag = SRCH_NO_MOVE;
         break;
     case CONTROL('W'): /* WRAP around */
-        if (mca != A_FILTER)
+        if (mca != A_FILTER && mca != A_HIGHLIGHT)
             flag = SRCH_WRAP;
         break;
+    case CONTROL('T'): /* counT all matches */
+        if (mca != A_FILTER && mca != A_HIGHLIGHT)
+            flag = SRCH_COUNT;
+        break;
     case CONTROL('R'): /* Don't use REGULAR EXPRESSIONS */
         flag = SRCH_NO_REGEX;
         break;
     case CONTROL('N'): /* NOT match */
     case '!':
-        flag = SRCH_NO_MATCH;
+        if (mca != A_HIGHLIGHT)
+            flag = SRCH_NO_MATCH;
         break;
     }
 
@@ -655,6 +671,7 @@ mca_char(c)
     case A_F_SEARCH:
     case A_B_SEARCH:
     case A_FILTER:
+    case A_HIGHLIGHT:
         ret = mca_search_char(c);
         if (ret != NO_MCA)
             return (ret);
@@ -754,7 +771,9 @@ clear_buffers(VOID_PARAM)
     clr_linenum();
 #if HILITE_SEARCH
     clr_hilite();
+    clr_filter_index();
 #endif
+    clr_match_index();
 }
 
 /*
@@ -887,6 +906,66 @@ prompt(VOID_PARAM)
     clear_eol();
 }
 
+/*
+ * Until the user types something, read ahead in a pipe, with
+ * --scan-ahead count lines in the current file, and while filtering
+ * index the lines hidden by the filters.  Every few slices, and when
+ * the work is complete, redisplay the prompt if that would change it.
+ * first is what new_file was when the prompt was displayed.
+ */
+#define SA_REDRAW       16      /* Slices counted between prompt updates */
+
+    static void
+work_while_idle(first)
+    int first;
+{
+    char *shown;
+    char *p;
+    int slices = 0;
+    int more = 1;
+    int fd;
+
+    if (ungot != NULL || tty_pending())
+        return;
+    while (!sigs && (fd = ch_prefetch_fd(bottompos)) >= 0)
+    {
+        if (tty_wait(fd))
+            return;
+        ch_prefetch();
+    }
+    if (sigs)
+        return;
+#if HILITE_SEARCH
+    if (!scan_ahead && !is_filtering())
+        return;
+#else
+    if (!scan_ahead)
+        return;
+#endif
+    new_file = first;
+    shown = save(pr_string());
+    while (more && !sigs && !tty_pending())
+    {
+        more = scan_ahead && scan_ahead_step();
+#if HILITE_SEARCH
+        if (!more)
+            more = filter_index_step();
+#endif
+        if (more && ++slices % SA_REDRAW != 0)
+            continue;
+        new_file = first;
+        p = pr_string();
+        if (strcmp(p, shown) == 0)
+            continue;
+        free(shown);
+        shown = save(p);
+        new_file = first;
+        prompt();
+        flush();
+    }
+    free(shown);
+}
+
 /*
  * Display the less version message.
  */
@@ -899,6 +978,33 @@ dispversion(VOID_PARAM)
     error("less %s", &parg);
 }
 
+/*
+ * Display how much memory is used by the buffers
+ * and by the trees of highlighted and filtered lines.
+ */
+    static void
+dispmemory(VOID_PARAM)
+{
+    PARG parg[7];
+#if HILITE_SEARCH
+    int used;
+    int nodes;
+#endif
+
+    parg[0].p_int = (int) ((ch_memory() + 1023) / 1024);
+#if HILITE_SEARCH
+    parg[3].p_int = (int) ((hlist_usage(FALSE, &used, &nodes) + 1023) / 1024);
+    parg[1].p_int = used;
+    parg[2].p_int = nodes;
+    parg[6].p_int = (int) ((hlist_usage(TRUE, &used, &nodes) + 1023) / 1024);
+    parg[4].p_int = used;
+    parg[5].p_int = nodes;
+    error("Buffers %dK, highlights %d of %d nodes (%dK), filter %d of %d nodes (%dK)", parg);
+#else
+    error("Buffers %dK", parg);
+#endif
+}
+
 /*
  * Return a character to complete a partial command, if possible.
  */
@@ -1192,7 +1298,10 @@ forw_loop(until_hilite)
             break;
         }
         make_display();
-        forward(1, 0, 0);
+        if (until_hilite)
+            forward(1, 0, 0);
+        else
+            forw_follow();
     }
     ignore_eoi = 0;
     ch_set_eof();
@@ -1226,6 +1335,7 @@ commands(VOID_PARAM)
     IFILE old_ifile;
     IFILE new_ifile;
     char *tagfile;
+    int first_prompt;
 
     search_type = SRCH_FORW;
     wscroll = (sc_height + 1) / 2;
@@ -1258,11 +1368,17 @@ commands(VOID_PARAM)
          * Display prompt and accept a character.
          */
         cmd_reset();
+        first_prompt = new_file;
         prompt();
         if (sigs)
             continue;
         if (newaction == A_NOACTION)
+        {
+            work_while_idle(first_prompt);
+            if (sigs)
+                continue;
             c = getcc();
+        }
 
     again:
         if (sigs)
@@ -1514,8 +1630,10 @@ commands(VOID_PARAM)
         case A_REPAINT:
             /*
              * Repaint screen.
+             * Don't trust what we think is on it.
              */
             cmd_exec();
+            scr_forget();
             repaint();
             break;
 
@@ -1605,6 +1723,14 @@ commands(VOID_PARAM)
             dispversion();
             break;
 
+        case A_DEBUG:
+            /*
+             * Print memory usage.
+             */
+            cmd_exec();
+            dispmemory();
+            break;
+
         case A_QUIT:
             /*
              * Exit.
@@ -1672,6 +1798,20 @@ commands(VOID_PARAM)
             break;
 #endif
 
+        case A_HIGHLIGHT:
+#if HILITE_SEARCH
+            /*
+             * Set a highlight pattern.
+             */
+            search_type = SRCH_FORW | SRCH_HIGHLIGHT;
+            mca_search();
+            c = getcc();
+            goto again;
+#else
+            error("Command not available", NULL_PARG);
+            break;
+#endif
+
         case A_AGAIN_SEARCH:
             /*
              * Repeat previous search.
@@ -49,12 +49,119 @@ cvt_alloc_chpos(len)
     return (chpos);
 }
 
+/*
+ * Plain ASCII text is scanned a word at a time.
+ * With no high bit set in a word, adding to a byte cannot carry
+ * into the next byte, so all the bytes can be tested at once.
+ */
+#define WORD_BYTES      ((int) sizeof(unsigned long))
+#define WORD_ONES       (~0UL / 255)
+#define WORD_HIGHS      (WORD_ONES * 0x80)
+
+/* Does a word of ASCII bytes hold a control char? */
+#define word_has_ctl(w) (((w) - WORD_ONES * ' ') & ~(w) & WORD_HIGHS)
+
+/* The high bit of each byte of a word of ASCII bytes which is uppercase. */
+#define word_uppers(w) \
+    (((w) + WORD_ONES * (0x80 - 'A')) & ~((w) + WORD_ONES * (0x80 - 'Z' - 1)) & WORD_HIGHS)
+
+/*
+ * Would cvt_text copy a byte to its place in the output,
+ * changing nothing except perhaps its case?
+ */
+#define plain_byte(c, ops) \
+    (IS_ASCII_OCTET(c) && \
+     !(((ops) & CVT_BS) && (c) == '\b') && \
+     !(((ops) & CVT_ANSI) && (c) == ESC))
+
+/*
+ * Find how much of the start of a string is plain ASCII, which
+ * cvt_text would at most lowercase, leaving each char at its offset.
+ * If dst is not NULL, convert that much of the string into dst.
+ * If dst is NULL, stop also at (or a little before) a char which
+ * would be lowercased.
+ */
+    static int
+ascii_span(dst, src, len, ops)
+    char *dst;
+    constant char *src;
+    int len;
+    int ops;
+{
+    int i;
+    int c;
+    unsigned long w;
+    unsigned long uppers;
+
+    i = 0;
+    while (i < len)
+    {
+        if (i + WORD_BYTES <= len)
+        {
+            memcpy(&w, src + i, WORD_BYTES);
+            if (!(w & WORD_HIGHS) && !word_has_ctl(w))
+            {
+                uppers = (ops & CVT_TO_LC) ? word_uppers(w) : 0;
+                if (dst == NULL)
+                {
+                    if (uppers != 0)
+                        break;
+                } else
+                {
+                    /* Lowercase by setting the 0x20 bit of each uppercase letter. */
+                    w |= uppers >> 2;
+                    memcpy(dst + i, &w, WORD_BYTES);
+                }
+                i += WORD_BYTES;
+                continue;
+            }
+        }
+        /* Look at one byte: a control char, or one near the end. */
+        c = (unsigned char) src[i];
+        if (!plain_byte(c, ops))
+            break;
+        if ((ops & CVT_TO_LC) && c >= 'A' && c <= 'Z')
+        {
+            if (dst == NULL)
+                break;
+            c += 'a' - 'A';
+        }
+        if (dst != NULL)
+            dst[i] = (char) c;
+        i++;
+    }
+    return (i);
+}
+
+/*
+ * Would cvt_text leave a string unchanged, except perhaps for
+ * removing a carriage return at the end?
+ * It does if the string is all ASCII and has nothing which ops
+ * remove or change.  Return the length the string would have
+ * after conversion, or -1 if it must be converted.
+ */
+    public int
+cvt_unchanged(src, len, ops)
+    constant char *src;
+    int len;
+    int ops;
+{
+    if (ascii_span((char *) NULL, src, len, ops) < len)
+        return (-1);
+    if ((ops & CVT_CRLF) && len > 0 && src[len-1] == '\r')
+        len--;
+    return (len);
+}
+
 /*
  * Convert text.  Perform the transformations specified by ops.
  * Returns converted text in odst.  The original offset of each
  * odst character (when it was in osrc) is returned in the chpos array.
+ * Every entry up to the end of the converted text is set, so chpos
+ * need not be initialized by the caller.
+ * Return TRUE if every char has kept its offset; chpos is not set then.
  */
-    public void
+    public int
 cvt_text(odst, osrc, chpos, lenp, ops)
     char *odst;
     char *osrc;
@@ -63,17 +170,32 @@ cvt_text(odst, osrc, chpos, lenp, ops)
     int ops;
 {
     char *dst;
-    char *edst = odst;
+    char *edst;
     char *src;
     char *src_end;
     LWCHAR ch;
+    int n;
+    int i;
+    int same_pos;
 
     if (lenp != NULL)
         src_end = osrc + *lenp;
     else
         src_end = osrc + strlen(osrc);
 
-    for (src = osrc, dst = odst;  src < src_end;  )
+    /*
+     * Most text is plain ASCII; convert as much as possible
+     * of that a word at a time.
+     */
+    n = ascii_span(odst, osrc, (int) (src_end - osrc), ops);
+    src = osrc + n;
+    dst = edst = odst + n;
+    same_pos = (src == src_end);
+    if (chpos != NULL && !same_pos)
+        for (i = 0;  i < n;  i++)
+            chpos[i] = i;
+
+    while (src < src_end)
     {
         int src_pos = (int) (src - osrc);
         int dst_pos = (int) (dst - odst);
@@ -102,17 +224,31 @@ cvt_text(odst, osrc, chpos, lenp, ops)
             if ((ops & CVT_TO_LC) && IS_UPPER(ch))
                 ch = TO_LOWER(ch);
             put_wchar(&dst, ch);
-            /* Record the original position of the char. */
+            /*
+             * Record the original position of the char.
+             * Any later bytes of a multibyte char get no position.
+             */
             if (chpos != NULL)
+            {
                 chpos[dst_pos] = src_pos;
+                for (i = dst_pos + 1;  i < (int) (dst - odst);  i++)
+                    chpos[i] = -1;
+            }
         }
         if (dst > edst)
             edst = dst;
     }
     if ((ops & CVT_CRLF) && edst > odst && edst[-1] == '\r')
         edst--;
+    else if (chpos != NULL && !same_pos)
+        /*
+         * Record the position just past the last char too,
+         * so the end of a match at the end of the line can be found.
+         * (A removed carriage return has left its own position there.)
+         */
+        chpos[edst - odst] = (int) (src - osrc);
     *edst = '\0';
     if (lenp != NULL)
         *lenp = (int) (edst - odst);
-    /* FIXME: why was this here?  if (chpos != NULL) chpos[dst - odst] = src - osrc; */
+    return (same_pos);
 }
@@ -90,6 +90,7 @@ static unsigned char cmdtable[] =
     CONTROL('L'),0,                 A_REPAINT,
     ESC,'u',0,                      A_UNDO_SEARCH,
     ESC,'U',0,                      A_CLR_SEARCH,
+    ESC,'h',0,                      A_HIGHLIGHT,
     'g',0,                          A_GOLINE,
     SK(SK_HOME),0,                  A_GOLINE,
     '<',0,                          A_GOLINE,
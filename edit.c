@@ -165,6 +165,8 @@ close_pipe(FILE *pipefd)
     kill(pipefd->_pid, SIGINT);
 #endif
     pclose(pipefd);
+    /* The piped process may have written to the terminal. */
+    scr_forget();
 }
 
 /*
@@ -191,6 +193,7 @@ close_file(VOID_PARAM)
         store_pos(curr_ifile, &scrpos);
         lastmark();
     }
+    save_line_index();
     /*
      * Close the file descriptor, unless it is a pipe.
      */
@@ -482,7 +485,9 @@ edit_ifile(ifile)
         clr_linenum();
 #if HILITE_SEARCH
         clr_hilite();
+        clr_filter_index();
 #endif
+        clr_match_index();
         hshift = 0;
         if (strcmp(filename, FAKE_HELPFILE) && strcmp(filename, FAKE_EMPTYFILE))
         {
@@ -605,6 +605,10 @@ shellcmd(cmd)
      * standard devices.  Restore binary input mode.
      */
     SET_BINARY(0);
+    /*
+     * The command may write to the terminal behind our back.
+     */
+    scr_forget();
     return (fd);
 }
 
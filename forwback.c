@@ -22,6 +22,9 @@ public int no_back_scroll = 0;
 public int forw_prompt;
 public int first_time = 1;
 
+/* Most lines taken at once in follow mode, in screens */
+#define FOLLOW_MAX_SCREENS  64
+
 extern int sigs;
 extern int top_scroll;
 extern int quiet;
@@ -36,6 +39,7 @@ extern int clear_bg;
 extern int final_attr;
 extern int header_lines;
 extern int header_cols;
+extern int follow_rate;
 #if HILITE_SEARCH
 extern int size_linebuf;
 extern int hilite_search;
@@ -204,6 +208,8 @@ overlay_header(VOID_PARAM)
                 put_line();
             }
         }
+        /* The screen now shows lines put together from two places. */
+        scr_forget();
         moved = TRUE;
     }
     if (moved)
@@ -246,7 +252,8 @@ forw(n, pos, force, only_last, nblank)
         (forw_scroll >= 0 && n > forw_scroll && n != sc_height-1);
 
 #if HILITE_SEARCH
-    if (hilite_search == OPT_ONPLUS || is_filtering() || status_col) {
+    if (hilite_search == OPT_ONPLUS || is_filtering() || status_col ||
+        is_highlighting()) {
         prep_hilite(pos, pos + 4*size_linebuf, ignore_eoi ? 1 : -1);
         pos = next_unfiltered(pos);
     }
@@ -265,8 +272,11 @@ forw(n, pos, force, only_last, nblank)
             pos_clear();
             add_forw_pos(pos);
             force = 1;
-            clear();
-            home();
+            if (first_time || !begin_screen_diff())
+            {
+                clear();
+                home();
+            }
         }
 
         if (pos != position(BOTTOM_PLUS_ONE) || empty_screen())
@@ -279,13 +289,17 @@ forw(n, pos, force, only_last, nblank)
             pos_clear();
             add_forw_pos(pos);
             force = 1;
-            if (top_scroll)
+            if (!first_time && begin_screen_diff())
+            {
+                /* Draw the new screen over the old one. */
+            } else if (top_scroll)
             {
                 clear();
                 home();
             } else if (!first_time && !is_filtering())
             {
                 putstr("...skipping...\n");
+                scr_forget();
             }
         }
     }
@@ -423,7 +437,8 @@ back(n, pos, force, only_last)
     squish_check();
     do_repaint = (n > get_back_scroll() || (only_last && n > sc_height-1) || header_lines > 0);
 #if HILITE_SEARCH
-    if (hilite_search == OPT_ONPLUS || is_filtering() || status_col) {
+    if (hilite_search == OPT_ONPLUS || is_filtering() || status_col ||
+        is_highlighting()) {
         prep_hilite((pos < 3*size_linebuf) ?  0 : pos - 3*size_linebuf, pos, -1);
     }
 #endif
@@ -522,6 +537,90 @@ forward(n, force, only_last)
     forw(n, pos, force, only_last, 0);
 }
 
+/*
+ * Count the complete lines which can be read from pos without
+ * waiting for more input, up to maxlines.
+ * Set *endp to the position just past the last of them.
+ */
+    static int
+follow_ready(pos, maxlines, endp)
+    POSITION pos;
+    int maxlines;
+    POSITION *endp;
+{
+    unsigned char *p;
+    unsigned char *q;
+    unsigned char *nl;
+    int len;
+    int nlines = 0;
+
+    *endp = pos;
+    if (ch_seek(pos))
+        return (0);
+    ch_set_nowait(1);
+    while (nlines < maxlines && !ABORT_SIGS() &&
+           (len = ch_forw_span(&p)) > 0)
+    {
+        q = p;
+        while (nlines < maxlines && (nl = (unsigned char *)
+                memchr(q, '\n', (size_t) (p + len - q))) != NULL)
+        {
+            q = nl + 1;
+            nlines++;
+        }
+        if (q > p)
+            *endp = ch_tell() + (POSITION) (q - p);
+        ch_skip((POSITION) len);
+    }
+    ch_set_nowait(0);
+    return (nlines);
+}
+
+/*
+ * Display the lines which have been added to the file, in follow mode.
+ * All the complete lines which have already arrived are scrolled
+ * onto the screen together.  If they are more than a screen,
+ * only the last screen of them is drawn; the rest would just
+ * scroll off again.  If none have arrived, wait for the next line.
+ */
+    public void
+forw_follow(VOID_PARAM)
+{
+    POSITION pos;
+    POSITION epos;
+    int nlines;
+
+    pos = position(BOTTOM_PLUS_ONE);
+    if (pos == NULL_POSITION || get_quit_at_eof() || is_filtering())
+        nlines = 0;
+    else
+        nlines = follow_ready(pos, FOLLOW_MAX_SCREENS * sc_height, &epos);
+    if (nlines == 0)
+        forward(1, 0, 0);
+    else
+    {
+        /*
+         * Don't let drawing the new lines wait for lines which have
+         * not arrived yet (e.g. while highlighting searches past them).
+         */
+        ch_set_nowait(1);
+        if (nlines < sc_height - 1)
+            forward(nlines, 0, 1);
+        else
+            jump_line_loc(epos - 1, sc_height - 1);
+        ch_set_nowait(0);
+    }
+    if (follow_rate > 0 && !sigs)
+    {
+        /*
+         * Show this frame, then let the lines which
+         * arrive until the next one collect.
+         */
+        flush();
+        follow_wait();
+    }
+}
+
 /*
  * Display n more lines, backward.
  * Start just before the line currently displayed at the top of the screen.
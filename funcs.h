@@ -20,6 +20,10 @@ public void lower_left LESSPARAMS ((VOID_PARAM));
 public void line_left LESSPARAMS ((VOID_PARAM));
 public void check_winch LESSPARAMS ((VOID_PARAM));
 public void goto_line LESSPARAMS ((int sindex));
+public void goto_col LESSPARAMS ((int sindex, int col));
+public int goto_col_cost LESSPARAMS ((int sindex, int col));
+public int clear_cost LESSPARAMS ((VOID_PARAM));
+public int clear_eol_cost LESSPARAMS ((VOID_PARAM));
 public void vbell LESSPARAMS ((VOID_PARAM));
 public void bell LESSPARAMS ((VOID_PARAM));
 public void clear LESSPARAMS ((VOID_PARAM));
@@ -48,10 +52,19 @@ public POSITION ch_length LESSPARAMS ((VOID_PARAM));
 public POSITION ch_tell LESSPARAMS ((VOID_PARAM));
 public int ch_forw_get LESSPARAMS ((VOID_PARAM));
 public int ch_back_get LESSPARAMS ((VOID_PARAM));
+public int ch_forw_span LESSPARAMS ((unsigned char **pp));
+public int ch_back_span LESSPARAMS ((unsigned char **pp));
+public int ch_span_lost LESSPARAMS ((VOID_PARAM));
+public void ch_skip LESSPARAMS ((POSITION n));
+public unsigned char * ch_mapped LESSPARAMS ((POSITION *plen));
 public void ch_setbufspace LESSPARAMS ((int bufspace));
+public POSITION ch_memory LESSPARAMS ((VOID_PARAM));
 public void ch_flush LESSPARAMS ((VOID_PARAM));
+public int ch_prefetch_fd LESSPARAMS ((POSITION pos));
+public void ch_prefetch LESSPARAMS ((VOID_PARAM));
 public int seekable LESSPARAMS ((int f));
 public void ch_set_eof LESSPARAMS ((VOID_PARAM));
+public void ch_set_nowait LESSPARAMS ((int nowait));
 public void ch_init LESSPARAMS ((int f, int flags));
 public void ch_close LESSPARAMS ((VOID_PARAM));
 public int ch_getflags LESSPARAMS ((VOID_PARAM));
@@ -84,7 +97,10 @@ public int cmd_char LESSPARAMS ((int c));
 public LINENUM cmd_int LESSPARAMS ((long *frac));
 public char * get_cmdbuf LESSPARAMS ((VOID_PARAM));
 public char * cmd_lastpattern LESSPARAMS ((VOID_PARAM));
+public char * histfile_sidecar LESSPARAMS ((char *suffix));
 public void init_cmdhist LESSPARAMS ((VOID_PARAM));
+public char * make_tempname LESSPARAMS ((char *filename));
+public void make_file_private LESSPARAMS ((FILE *f));
 public void save_cmdhist LESSPARAMS ((VOID_PARAM));
 public int in_mca LESSPARAMS ((VOID_PARAM));
 public int norm_search_type LESSPARAMS ((int st));
@@ -97,7 +113,8 @@ public LWCHAR peekcc LESSPARAMS ((VOID_PARAM));
 public void commands LESSPARAMS ((VOID_PARAM));
 public size_t cvt_length LESSPARAMS ((size_t len, int ops));
 public int * cvt_alloc_chpos LESSPARAMS ((size_t len));
-public void cvt_text LESSPARAMS ((char *odst, char *osrc, int *chpos, int *lenp, int ops));
+public int cvt_unchanged LESSPARAMS ((constant char *src, int len, int ops));
+public int cvt_text LESSPARAMS ((char *odst, char *osrc, int *chpos, int *lenp, int ops));
 public void expand_cmd_tables LESSPARAMS ((VOID_PARAM));
 public void init_cmds LESSPARAMS ((VOID_PARAM));
 public void add_fcmd_table LESSPARAMS ((char *buf, int len));
@@ -153,6 +170,7 @@ public int overlay_header LESSPARAMS ((VOID_PARAM));
 public void forw LESSPARAMS ((int n, POSITION pos, int force, int only_last, int nblank));
 public void back LESSPARAMS ((int n, POSITION pos, int force, int only_last));
 public void forward LESSPARAMS ((int n, int force, int only_last));
+public void forw_follow LESSPARAMS ((VOID_PARAM));
 public void backward LESSPARAMS ((int n, int force, int only_last));
 public int get_back_scroll LESSPARAMS ((VOID_PARAM));
 public int get_one_screen LESSPARAMS ((VOID_PARAM));
@@ -208,8 +226,11 @@ public void pdone LESSPARAMS ((int endline, int chopped, int forw));
 public void set_attr_line LESSPARAMS ((int a));
 public void set_status_col LESSPARAMS ((int c, int attr));
 public int gline LESSPARAMS ((int i, int *ap));
+public int gline_run LESSPARAMS ((int i, char **pchars, int **pattrs));
+public int line_at_edge LESSPARAMS ((VOID_PARAM));
 public void null_line LESSPARAMS ((VOID_PARAM));
 public POSITION forw_raw_line LESSPARAMS ((POSITION curr_pos, char **linep, int *line_lenp));
+public POSITION forw_raw_line_nocopy LESSPARAMS ((POSITION curr_pos, char **linep, int *line_lenp));
 public POSITION back_raw_line LESSPARAMS ((POSITION curr_pos, char **linep, int *line_lenp));
 public void load_line LESSPARAMS ((constant char *str));
 public int rrshift LESSPARAMS ((VOID_PARAM));
@@ -217,10 +238,13 @@ public int set_color_map LESSPARAMS ((int attr, char *colorstr));
 public char * get_color_map LESSPARAMS ((int attr));
 public void clr_linenum LESSPARAMS ((VOID_PARAM));
 public void add_lnum LESSPARAMS ((LINENUM linenum, POSITION pos));
+public void save_line_index LESSPARAMS ((VOID_PARAM));
 public LINENUM find_linenum LESSPARAMS ((POSITION pos));
 public POSITION find_pos LESSPARAMS ((LINENUM linenum));
 public LINENUM currline LESSPARAMS ((int where));
 public void scan_eof LESSPARAMS ((VOID_PARAM));
+public int scan_ahead_progress LESSPARAMS ((POSITION *pbytes, LINENUM *plines));
+public int scan_ahead_step LESSPARAMS ((VOID_PARAM));
 public LINENUM vlinenum LESSPARAMS ((LINENUM linenum));
 public void lsystem LESSPARAMS ((char *cmd, char *donemsg));
 public int pipe_mark LESSPARAMS ((int c, char *cmd));
@@ -248,6 +272,7 @@ public void opt_ks LESSPARAMS ((int type, char *s));
 public void opt_t LESSPARAMS ((int type, char *s));
 public void opt__T LESSPARAMS ((int type, char *s));
 public void opt_p LESSPARAMS ((int type, char *s));
+public void opt_grep LESSPARAMS ((int type, char *s));
 public void opt__P LESSPARAMS ((int type, char *s));
 public void opt_b LESSPARAMS ((int type, char *s));
 public void opt_i LESSPARAMS ((int type, char *s));
@@ -283,29 +308,51 @@ public void init_option LESSPARAMS ((VOID_PARAM));
 public struct loption * findopt LESSPARAMS ((int c));
 public struct loption * findopt_name LESSPARAMS ((char **p_optname, char **p_oname, int *p_err));
 public int iread LESSPARAMS ((int fd, unsigned char *buf, unsigned int len));
+public int tty_pending LESSPARAMS ((VOID_PARAM));
+public int fd_pending LESSPARAMS ((int fd));
+public int tty_wait LESSPARAMS ((int fd));
 public void intread LESSPARAMS ((VOID_PARAM));
+public void follow_wait LESSPARAMS ((VOID_PARAM));
 public time_type get_time LESSPARAMS ((VOID_PARAM));
 public char * errno_message LESSPARAMS ((char *filename));
 public int percentage LESSPARAMS ((POSITION num, POSITION den));
 public POSITION percent_pos LESSPARAMS ((POSITION pos, int percent, long fraction));
 public int  os9_signal LESSPARAMS ((int type, RETSIGTYPE (*handler)()));
 public void sleep_ms LESSPARAMS ((int ms));
+public void scr_forget LESSPARAMS ((VOID_PARAM));
+public void scr_clear LESSPARAMS ((VOID_PARAM));
+public int scr_move LESSPARAMS ((int row));
+public int scr_add_line LESSPARAMS ((VOID_PARAM));
+public int scr_clear_eol LESSPARAMS ((VOID_PARAM));
+public int begin_screen_diff LESSPARAMS ((VOID_PARAM));
+public void end_screen_diff LESSPARAMS ((VOID_PARAM));
 public void put_line LESSPARAMS ((VOID_PARAM));
 public void flush LESSPARAMS ((VOID_PARAM));
+public void output_done LESSPARAMS ((VOID_PARAM));
+public void output_counts LESSPARAMS ((POSITION *pbytes, int *pwrites));
 public void set_output LESSPARAMS ((int fd));
 public int putchr LESSPARAMS ((int c));
 public void clear_bot_if_needed LESSPARAMS ((VOID_PARAM));
+public void putbytes LESSPARAMS ((constant char *s, int n));
 public void putstr LESSPARAMS ((constant char *s));
 public int less_printf LESSPARAMS ((char *fmt, PARG *parg));
 public void get_return LESSPARAMS ((VOID_PARAM));
 public void error LESSPARAMS ((char *fmt, PARG *parg));
 public void ierror LESSPARAMS ((char *fmt, PARG *parg));
 public int query LESSPARAMS ((char *fmt, PARG *parg));
-public int compile_pattern LESSPARAMS ((char *pattern, int search_type, int show_error, PATTERN_TYPE *comp_pattern));
+public int compile_pattern LESSPARAMS ((char *pattern, int search_type, int caseless, int show_error, PATTERN_TYPE *comp_pattern));
 public void uncompile_pattern LESSPARAMS ((PATTERN_TYPE *pattern));
 public int valid_pattern LESSPARAMS ((char *pattern));
 public int is_null_pattern LESSPARAMS ((PATTERN_TYPE pattern));
-public int match_pattern LESSPARAMS ((PATTERN_TYPE pattern, char *tpattern, char *line, size_t line_len, char **sp, char **ep, int notbol, int search_type));
+public int thread_pattern LESSPARAMS ((PATTERN_TYPE pattern, char *text, int search_type, int caseless, PATTERN_TYPE *copy));
+public void free_thread_pattern LESSPARAMS ((PATTERN_TYPE *copy));
+public struct literal * compile_literal LESSPARAMS ((char *pattern, int search_type, int caseless));
+public void uncompile_literal LESSPARAMS ((struct literal **plit));
+public char * find_literal LESSPARAMS ((struct literal *lit, char *buf, size_t buf_len));
+public struct litset * compile_litset LESSPARAMS ((struct literal **lits, int nlits));
+public void uncompile_litset LESSPARAMS ((struct litset **pset));
+public unsigned long scan_litset LESSPARAMS ((struct litset *set, char *buf, size_t buf_len));
+public int match_pattern LESSPARAMS ((PATTERN_TYPE pattern, struct literal *lit, char *line, size_t line_len, char **sp, char **ep, int notbol, int search_type));
 public char * pattern_lib_name LESSPARAMS ((VOID_PARAM));
 public POSITION position LESSPARAMS ((int sindex));
 public void add_forw_pos LESSPARAMS ((POSITION pos));
@@ -329,15 +376,26 @@ public void undo_search LESSPARAMS ((int clear));
 public void clr_hlist LESSPARAMS ((struct hilite_tree *anchor));
 public void clr_hilite LESSPARAMS ((VOID_PARAM));
 public void clr_filter LESSPARAMS ((VOID_PARAM));
+public void clr_filter_index LESSPARAMS ((VOID_PARAM));
 public int is_filtered LESSPARAMS ((POSITION pos));
 public POSITION next_unfiltered LESSPARAMS ((POSITION pos));
 public POSITION prev_unfiltered LESSPARAMS ((POSITION pos));
+public POSITION back_filtered LESSPARAMS ((POSITION pos));
 public int is_hilited_attr LESSPARAMS ((POSITION pos, POSITION epos, int nohide, int *p_matches));
+public long hlist_usage LESSPARAMS ((int filter, int *pused, int *palloc));
 public void chg_hilite LESSPARAMS ((VOID_PARAM));
+public int filter_index_step LESSPARAMS ((VOID_PARAM));
+public int filter_counts LESSPARAMS ((LINENUM *pshown, LINENUM *plines));
+public void clr_match_index LESSPARAMS ((VOID_PARAM));
+public int match_counts LESSPARAMS ((int *pk, int *pn));
+public int set_grep_pattern LESSPARAMS ((char *pattern));
+public void grep_file LESSPARAMS ((int follow));
 public void chg_caseless LESSPARAMS ((VOID_PARAM));
 public int search LESSPARAMS ((int search_type, char *pattern, int n));
 public void prep_hilite LESSPARAMS ((POSITION spos, POSITION epos, int maxlines));
 public void set_filter_pattern LESSPARAMS ((char *pattern, int search_type));
+public void set_highlight_pattern LESSPARAMS ((int n, char *pattern, int search_type));
+public int is_highlighting LESSPARAMS ((VOID_PARAM));
 public int is_filtering LESSPARAMS ((VOID_PARAM));
 public RETSIGTYPE winch LESSPARAMS ((int type));
 public void init_signals LESSPARAMS ((int on));
@@ -62,7 +62,8 @@ get_forw_line:
         return (NULL_POSITION);
     }
 #if HILITE_SEARCH
-    if (hilite_search == OPT_ONPLUS || is_filtering() || status_col)
+    if (hilite_search == OPT_ONPLUS || is_filtering() || status_col ||
+        is_highlighting())
     {
         /*
          * If we are ignoring EOI (command F), only prepare
@@ -284,13 +285,17 @@ back_line(curr_pos)
     int backchars;
 
 get_back_line:
+#if HILITE_SEARCH
+    curr_pos = back_filtered(curr_pos);
+#endif
     if (curr_pos == NULL_POSITION || curr_pos <= ch_zero())
     {
         null_line();
         return (NULL_POSITION);
     }
 #if HILITE_SEARCH
-    if (hilite_search == OPT_ONPLUS || is_filtering() || status_col)
+    if (hilite_search == OPT_ONPLUS || is_filtering() || status_col ||
+        is_highlighting())
         prep_hilite((curr_pos < 3*size_linebuf) ?
                 0 : curr_pos - 3*size_linebuf, curr_pos, -1);
 #endif
@@ -282,6 +282,8 @@ jump_loc(pos, sline)
         }
         lastmark();
         squished = 0;
+        if (screen_trashed)
+            scr_forget();
         screen_trashed = 0;
         forw(sc_height-1, pos, 1, 0, sindex-nline);
     } else
@@ -323,10 +325,13 @@ jump_loc(pos, sline)
             }
         }
         lastmark();
-        if (!top_scroll)
-            clear();
-        else
-            home();
+        if (!begin_screen_diff())
+        {
+            if (!top_scroll)
+                clear();
+            else
+                home();
+        }
         screen_trashed = 0;
         add_back_pos(pos);
         back(sc_height-1, pos, 1, 0);
@@ -393,6 +393,8 @@ struct wchar_range_table
 #define SRCH_FILTER     (1 << 13) /* Search is for '&' (filter) command */
 #define SRCH_AFTER_TARGET (1 << 14) /* Start search after the target line */
 #define SRCH_WRAP       (1 << 15) /* Wrap-around search (continue at BOF/EOF) */
+#define SRCH_COUNT      (1 << 16) /* Count all matches, using the match index */
+#define SRCH_HIGHLIGHT  (1 << 17) /* Search is for ESC-h (highlight) command */
 
 #define SRCH_REVERSE(t) (((t) & SRCH_FORW) ? \
                                 (((t) & ~SRCH_FORW) | SRCH_BACK) : \
@@ -433,6 +435,9 @@ struct wchar_range_table
 #define AT_COLOR_RSCROLL  (8 << AT_COLOR_SHIFT)
 #define AT_COLOR_SEARCH   (9 << AT_COLOR_SHIFT)
 #define AT_COLOR_HEADER   (11 << AT_COLOR_SHIFT)
+#define NUM_HIGHLIGHTS    4         /* Highlight patterns (ESC-h) */
+#define AT_COLOR_HIGHLIGHT(i) ((11+(i)) << AT_COLOR_SHIFT) /* i is 1 to NUM_HIGHLIGHTS */
+#define IS_HIGHLIGHT_ATTR(a)  (((a) & AT_COLOR) >= AT_COLOR_HIGHLIGHT(1))
 
 typedef enum { CT_NULL, CT_4BIT, CT_6BIT } COLOR_TYPE;
 
@@ -58,6 +58,7 @@ static struct lesskey_cmdname cmdnames[] =
     { "goto-line",            A_GOLINE },
     { "goto-mark",            A_GOMARK },
     { "help",                 A_HELP },
+    { "highlight",            A_HIGHLIGHT },
     { "index-file",           A_INDEX_FILE },
     { "invalid",              A_UINVALID },
     { "left-scroll",          A_LSHIFT },
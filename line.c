@@ -107,7 +107,7 @@ static int mbc_buf_index = 0;
 static POSITION mbc_pos;
 
 /* Configurable color map */
-static char color_map[AT_NUM_COLORS][12] = {
+static char color_map[][12] = {
     "Wm",  /* AT_COLOR_ATTN */
     "kR",  /* AT_COLOR_BIN */
     "kR",  /* AT_COLOR_CTRL */
@@ -118,6 +118,10 @@ static char color_map[AT_NUM_COLORS][12] = {
     "kc",  /* AT_COLOR_RSCROLL */
     "kG",  /* AT_COLOR_SEARCH */
     "",    /* AT_COLOR_HEADER */
+    "kR",  /* AT_COLOR_HIGHLIGHT(1) */
+    "kY",  /* AT_COLOR_HIGHLIGHT(2) */
+    "kC",  /* AT_COLOR_HIGHLIGHT(3) */
+    "kM",  /* AT_COLOR_HIGHLIGHT(4) */
     "",    /* AT_UNDERLINE */
     "",    /* AT_BOLD */
     "",    /* AT_BLINK */
@@ -732,7 +736,8 @@ store_char(ch, a, rep, pos)
              */
             if (a != AT_ANSI)
             {
-                if (highest_hilite != NULL_POSITION && pos != NULL_POSITION && pos > highest_hilite)
+                if (highest_hilite != NULL_POSITION && pos != NULL_POSITION && pos > highest_hilite &&
+                    !IS_HIGHLIGHT_ATTR(hl_attr))
                     highest_hilite = pos;
                 a |= hl_attr;
             }
@@ -1388,6 +1393,42 @@ gline(i, ap)
     return (linebuf.buf[i] & 0xFF);
 }
 
+/*
+ * Get a run of chars from the line buffer without calling gline
+ * for each one: point *pchars and *pattrs at the char which gline
+ * would return for index i, and its attribute, and return how many
+ * chars there are in a row from there.  Return 0 if the chars must
+ * be fetched with gline, as for a null line.
+ */
+    public int
+gline_run(i, pchars, pattrs)
+    int i;
+    char **pchars;
+    int **pattrs;
+{
+    if (is_null_line)
+        return (0);
+    if (i < linebuf.pfx_end)
+    {
+        *pchars = &linebuf.pfx[i];
+        *pattrs = &linebuf.pfx_attr[i];
+        return (linebuf.pfx_end - i);
+    }
+    i += linebuf.print - linebuf.pfx_end;
+    *pchars = &linebuf.buf[i];
+    *pattrs = &linebuf.attr[i];
+    return (linebuf.end - i);
+}
+
+/*
+ * Does the line in the line buffer reach the right edge of the screen?
+ */
+    public int
+line_at_edge(VOID_PARAM)
+{
+    return (!is_null_line && end_column >= sc_width + cshift);
+}
+
 /*
  * Indicate that there is no current line.
  */
@@ -1398,9 +1439,29 @@ null_line(VOID_PARAM)
     cshift = 0;
 }
 
+/*
+ * Find the last occurrence of a char in a buffer.
+ */
+    static unsigned char *
+last_char(buf, c, len)
+    unsigned char *buf;
+    int c;
+    int len;
+{
+    unsigned char *p;
+
+    for (p = buf + len;  p > buf;  )
+        if (*--p == c)
+            return (p);
+    return (NULL);
+}
+
 /*
  * Analogous to forw_line(), but deals with "raw lines":
  * lines which are not split for screen width.
+ * Rather than getting one char at a time, we take whole runs
+ * of the input buffer from ch_forw_span and search each one
+ * for the newline.
  * {{ This is supposed to be more efficient than forw_line(). }}
  */
     public POSITION
@@ -1410,37 +1471,69 @@ forw_raw_line(curr_pos, linep, line_lenp)
     int *line_lenp;
 {
     int n;
-    int c;
+    int len;
+    int clen;
+    unsigned char *p;
+    unsigned char *nl;
+    int want_line = (linep != NULL || line_lenp != NULL);
+    int overflow = FALSE;
     POSITION new_pos;
 
     if (curr_pos == NULL_POSITION || ch_seek(curr_pos) ||
-        (c = ch_forw_get()) == EOI)
+        (len = ch_forw_span(&p)) == 0)
         return (NULL_POSITION);
 
     n = 0;
     for (;;)
     {
-        if (c == '\n' || c == EOI || ABORT_SIGS())
+        if (len == 0 || ABORT_SIGS())
         {
             new_pos = ch_tell();
             break;
         }
-        if (n >= size_linebuf-1)
+        nl = (unsigned char *) memchr(p, '\n', (size_t) len);
+        clen = (nl != NULL) ? (int) (nl - p) : len;
+        if (want_line)
         {
-            if (expand_linebuf())
+            while (n + clen >= size_linebuf)
             {
-                /*
-                 * Overflowed the input buffer.
-                 * Pretend the line ended here.
-                 */
-                new_pos = ch_tell() - 1;
-                break;
+                if (expand_linebuf())
+                {
+                    /*
+                     * Overflowed the input buffer.
+                     * Pretend the line ended here.
+                     */
+                    clen = size_linebuf-1 - n;
+                    nl = NULL;
+                    overflow = TRUE;
+                    break;
+                }
             }
+            memcpy(&linebuf.buf[n], p, clen);
+            n += clen;
         }
-        linebuf.buf[n++] = c;
-        c = ch_forw_get();
+        if (ch_span_lost())
+        {
+            /* The file was truncated under us; read the line again. */
+            return (forw_raw_line(curr_pos, linep, line_lenp));
+        }
+        ch_skip((POSITION) clen);
+        if (nl != NULL)
+        {
+            /* Skip past the newline too. */
+            ch_skip((POSITION) 1);
+            new_pos = ch_tell();
+            break;
+        }
+        if (overflow)
+        {
+            new_pos = ch_tell();
+            break;
+        }
+        len = ch_forw_span(&p);
     }
-    linebuf.buf[n] = '\0';
+    if (want_line)
+        linebuf.buf[n] = '\0';
     if (linep != NULL)
         *linep = linebuf.buf;
     if (line_lenp != NULL)
@@ -1448,8 +1541,38 @@ forw_raw_line(curr_pos, linep, line_lenp)
     return (new_pos);
 }
 
+/*
+ * Like forw_raw_line, but if the whole line is in one run of the
+ * input buffer, just point *linep at it there rather than copying
+ * it into linebuf.  Such a line is not null-terminated, and it is
+ * valid only until the next call to a ch_ function which reads.
+ */
+    public POSITION
+forw_raw_line_nocopy(curr_pos, linep, line_lenp)
+    POSITION curr_pos;
+    char **linep;
+    int *line_lenp;
+{
+    int len;
+    unsigned char *p;
+    unsigned char *nl;
+
+    if (curr_pos == NULL_POSITION || ch_seek(curr_pos) ||
+        (len = ch_forw_span(&p)) == 0)
+        return (NULL_POSITION);
+    nl = (unsigned char *) memchr(p, '\n', (size_t) len);
+    if (nl == NULL || ch_span_lost())
+        return (forw_raw_line(curr_pos, linep, line_lenp));
+    *linep = (char *) p;
+    *line_lenp = (int) (nl - p);
+    ch_skip((POSITION) (nl - p) + 1);
+    return (ch_tell());
+}
+
 /*
  * Analogous to back_line(), but deals with "raw lines".
+ * Like forw_raw_line, this works on whole runs of the input buffer,
+ * taken from ch_back_span.
  * {{ This is supposed to be more efficient than back_line(). }}
  */
     public POSITION
@@ -1459,7 +1582,11 @@ back_raw_line(curr_pos, linep, line_lenp)
     int *line_lenp;
 {
     int n;
-    int c;
+    int len;
+    int clen;
+    unsigned char *p;
+    unsigned char *nl;
+    int want_line = (linep != NULL || line_lenp != NULL);
     POSITION new_pos;
 
     if (curr_pos == NULL_POSITION || curr_pos <= ch_zero() ||
@@ -1470,17 +1597,13 @@ back_raw_line(curr_pos, linep, line_lenp)
     linebuf.buf[--n] = '\0';
     for (;;)
     {
-        c = ch_back_get();
-        if (c == '\n' || ABORT_SIGS())
+        if (ABORT_SIGS())
         {
-            /*
-             * This is the newline ending the previous line.
-             * We have hit the beginning of the line.
-             */
-            new_pos = ch_tell() + 1;
+            new_pos = ch_tell();
             break;
         }
-        if (c == EOI)
+        len = ch_back_span(&p);
+        if (len == 0)
         {
             /*
              * We have hit the beginning of the file.
@@ -1490,30 +1613,48 @@ back_raw_line(curr_pos, linep, line_lenp)
             new_pos = ch_zero();
             break;
         }
-        if (n <= 0)
+        /*
+         * A newline in this run is the newline ending
+         * the previous line: our line starts just after it.
+         */
+        nl = last_char(p, '\n', len);
+        clen = (nl != NULL) ? (int) (p + len - (nl + 1)) : len;
+        if (want_line)
         {
-            int old_size_linebuf = size_linebuf;
-            char *fm;
-            char *to;
-            if (expand_linebuf())
+            while (n < clen)
             {
+                int old_size_linebuf = size_linebuf;
+                if (expand_linebuf())
+                {
+                    /*
+                     * Overflowed the input buffer.
+                     * Pretend the line ended here.
+                     */
+                    clen = n;
+                    nl = p;
+                    break;
+                }
                 /*
-                 * Overflowed the input buffer.
-                 * Pretend the line ended here.
+                 * Shift the data to the end of the new linebuf.
                  */
-                new_pos = ch_tell() + 1;
-                break;
+                memmove(linebuf.buf + size_linebuf - old_size_linebuf,
+                    linebuf.buf, old_size_linebuf);
+                n += size_linebuf - old_size_linebuf;
             }
-            /*
-             * Shift the data to the end of the new linebuf.
-             */
-            for (fm = linebuf.buf + old_size_linebuf - 1,
-                  to = linebuf.buf + size_linebuf - 1;
-                 fm >= linebuf.buf;  fm--, to--)
-                *to = *fm;
-            n = size_linebuf - old_size_linebuf;
+            n -= clen;
+            memcpy(&linebuf.buf[n], p + len - clen, clen);
+        }
+        if (ch_span_lost())
+        {
+            /* The file was truncated under us; read the line again. */
+            return (back_raw_line(curr_pos, linep, line_lenp));
+        }
+        ch_skip(-(POSITION) clen);
+        if (nl != NULL)
+        {
+            new_pos = ch_tell();
+            break;
         }
-        linebuf.buf[--n] = c;
     }
     if (linep != NULL)
         *linep = &linebuf.buf[n];
@@ -1614,15 +1755,17 @@ color_index(attr)
         case AT_COLOR_SEARCH:  return 8;
         case AT_COLOR_HEADER:  return 9;
         }
+        if (IS_HIGHLIGHT_ATTR(attr))
+            return 9 + (((attr & AT_COLOR) - AT_COLOR_HIGHLIGHT(0)) >> AT_COLOR_SHIFT);
     }
     if (attr & AT_UNDERLINE)
-        return 10;
+        return 14;
     if (attr & AT_BOLD)
-        return 11;
+        return 15;
     if (attr & AT_BLINK)
-        return 12;
+        return 16;
     if (attr & AT_STANDOUT)
-        return 13;
+        return 17;
     return -1;
 }
 
@@ -30,9 +30,24 @@
  * position in the file.  As a side effect, it calls add_lnum
  * to cache the line number.  Therefore currline is occasionally
  * called to make sure we cache line numbers often enough.
+ *
+ * With the --line-index option, seekable files also get a full index
+ * of line starts, built from the beginning of the file as far as it
+ * is needed.  To keep it small, the starts are stored as the byte
+ * distance from the previous start, in a variable number of bytes.
+ * Every LX_GROUP starts, the absolute position is kept in a separate
+ * "checkpoint" array, which can be binary searched.  Finding a line
+ * number then requires decoding at most LX_GROUP distances.
+ *
+ * A complete index of a large file is also saved in a cache file
+ * next to the history file, so it need not be rebuilt when the same
+ * file is viewed again.
  */
 
 #include "less.h"
+#if HAVE_STAT
+#include <sys/stat.h>
+#endif
 
 /*
  * Structure to keep track of a line number and the associated file position.
@@ -64,7 +79,74 @@ static struct linenum_info *freelist;   /* Anchor of the unused entries */
 static struct linenum_info pool[NPOOL]; /* The pool itself */
 static struct linenum_info *spare;              /* We always keep one spare entry */
 
+/*
+ * Structure to keep track of a group of line starts in the index.
+ */
+struct lx_group
+{
+    POSITION pos;                   /* Position of first start in group */
+    size_t offset;                  /* Offset in lx_deltas of the rest */
+};
+
+#define LX_GROUP        128             /* Line starts per checkpoint */
+#define LX_CHUNK        (64*1024)       /* Bytes scanned between checks */
+
+static struct lx_group *lx_groups;      /* Checkpoints */
+static int lx_ngroups;                  /* Number of checkpoints in use */
+static int lx_agroups;                  /* Number of checkpoints allocated */
+static unsigned char *lx_deltas;        /* Encoded distances between starts */
+static size_t lx_ndeltas;               /* Bytes of lx_deltas in use */
+static size_t lx_adeltas;               /* Bytes of lx_deltas allocated */
+static LINENUM lx_nstarts;              /* Number of starts (after pos 0) */
+static POSITION lx_last;                /* Last start in the index */
+static POSITION lx_scanned;             /* File is indexed up to here */
+static int lx_failed;                   /* Ran out of memory */
+
+#define SA_SLICE        (256*1024)      /* Bytes counted per scan_ahead_step */
+
+static POSITION sa_pos;                 /* Lines are counted up to here */
+static LINENUM sa_lines;                /* Number of lines before sa_pos */
+static int sa_done;                     /* Whole file has been counted */
+
+#if CMD_HISTORY && HAVE_STAT_INO
+#define LX_CACHE        1
+#define LX_CACHE_MIN    (1024*1024)     /* Smallest file worth caching */
+#define LX_CACHE_SLOTS  16              /* Number of cache files */
+#define LX_MAGIC        "LESSIDX1"
+
+/*
+ * Header of a line index cache file.
+ * The file is identified by device, i-number, size and modification time.
+ * The header is followed by the checkpoints and the encoded distances.
+ */
+struct lx_header
+{
+    char magic[8];
+    int posize;                     /* sizeof(POSITION) */
+    int group;                      /* LX_GROUP */
+    dev_t dev;
+    ino_t ino;
+    POSITION size;
+    time_t mtime;
+    LINENUM nstarts;
+    POSITION last;
+    int ngroups;
+    size_t ndeltas;
+};
+
+static struct lx_header lx_id;          /* Identity of the indexed file */
+static int lx_cache_checked;            /* Have looked for a cached index */
+static int lx_cache_known;              /* lx_id is valid */
+static int lx_cache_dirty;              /* Index has not been saved */
+
+extern int secure;
+extern IFILE curr_ifile;
+#endif
+
 extern int linenums;
+extern int line_index;
+extern int scan_ahead;
+extern int ignore_eoi;
 extern int sigs;
 extern int sc_height;
 extern int screen_trashed;
@@ -97,6 +179,28 @@ clr_linenum(VOID_PARAM)
     anchor.gap = 0;
     anchor.pos = (POSITION)0;
     anchor.line = 1;
+
+    /*
+     * Discard the line index.
+     */
+    if (lx_groups != NULL)
+        free(lx_groups);
+    if (lx_deltas != NULL)
+        free(lx_deltas);
+    lx_groups = NULL;
+    lx_deltas = NULL;
+    lx_ngroups = lx_agroups = 0;
+    lx_ndeltas = lx_adeltas = 0;
+    lx_nstarts = 0;
+    lx_last = lx_scanned = (POSITION)0;
+    lx_failed = 0;
+
+    sa_pos = (POSITION)0;
+    sa_lines = 0;
+    sa_done = 0;
+#if LX_CACHE
+    lx_cache_checked = lx_cache_known = lx_cache_dirty = 0;
+#endif
 }
 
 /*
@@ -261,6 +365,456 @@ abort_long(VOID_PARAM)
     error("Line numbers turned off", NULL_PARG);
 }
 
+#if LX_CACHE
+/*
+ * Get the name of the cache file for the current file.
+ * Files are spread over LX_CACHE_SLOTS cache files;
+ * a file replaces the index of another file in the same slot.
+ */
+    static char *
+lx_cache_name(VOID_PARAM)
+{
+    char suffix[32];
+    int slot;
+
+    slot = (int) (((unsigned long) lx_id.dev ^ (unsigned long) lx_id.ino) % LX_CACHE_SLOTS);
+    SNPRINTF1(suffix, sizeof(suffix), "-%d.idx", slot);
+    return (histfile_sidecar(suffix));
+}
+
+/*
+ * Check that the checkpoints and distances read from a cache file
+ * describe line starts which are in order and within the file,
+ * and that every distance ends within the distances of its group.
+ * The cache file may be stale, truncated or edited, so nothing
+ * in it is trusted until it has been checked.
+ */
+    static int
+lx_cache_valid(h, groups, deltas)
+    struct lx_header *h;
+    struct lx_group *groups;
+    unsigned char *deltas;
+{
+    int g;
+    LINENUM n;
+    LINENUM nd;
+    size_t off;
+    size_t end;
+    int shift;
+    POSITION delta;
+    POSITION spos = -1;
+
+    if (h->ngroups == 0)
+        return (h->ndeltas == 0 && h->last == 0);
+    if (groups[0].offset != 0)
+        return (0);
+    for (g = 0;  g < h->ngroups;  g++)
+    {
+        off = groups[g].offset;
+        end = (g + 1 < h->ngroups) ? groups[g+1].offset : h->ndeltas;
+        if (end < off || end > h->ndeltas)
+            return (0);
+        if (groups[g].pos <= spos || groups[g].pos > h->size)
+            return (0);
+        spos = groups[g].pos;
+        nd = h->nstarts - (LINENUM) g * LX_GROUP;
+        if (nd > LX_GROUP)
+            nd = LX_GROUP;
+        for (n = 1;  n < nd;  n++)
+        {
+            delta = 0;
+            shift = 0;
+            do
+            {
+                if (off >= end || shift > 8 * (int) sizeof(POSITION) - 8)
+                    return (0);
+                delta |= (POSITION) (deltas[off] & 0x7F) << shift;
+                shift += 7;
+            } while (deltas[off++] & 0x80);
+            if (delta <= 0 || delta > h->size - spos)
+                return (0);
+            spos += delta;
+        }
+        if (off != end)
+            return (0);
+    }
+    return (spos == h->last);
+}
+
+/*
+ * Read the line index of the current file from its cache file, if any.
+ */
+    static void
+lx_cache_load(VOID_PARAM)
+{
+    struct stat statbuf;
+    struct lx_header h;
+    struct lx_group *groups;
+    unsigned char *deltas;
+    char *name;
+    FILE *f;
+    int ok;
+
+    lx_cache_checked = 1;
+    if (secure || get_altfilename(curr_ifile) != NULL)
+        return;
+    if (stat(get_filename(curr_ifile), &statbuf) < 0 ||
+        statbuf.st_size != ch_length() || statbuf.st_size < LX_CACHE_MIN)
+        return;
+    memset(&lx_id, 0, sizeof(lx_id));
+    memcpy(lx_id.magic, LX_MAGIC, sizeof(lx_id.magic));
+    lx_id.posize = sizeof(POSITION);
+    lx_id.group = LX_GROUP;
+    lx_id.dev = statbuf.st_dev;
+    lx_id.ino = statbuf.st_ino;
+    lx_id.size = statbuf.st_size;
+    lx_id.mtime = statbuf.st_mtime;
+    lx_cache_known = 1;
+
+    name = lx_cache_name();
+    if (name == NULL)
+        return;
+    f = fopen(name, "rb");
+    free(name);
+    if (f == NULL)
+        return;
+    /*
+     * Each start is at a different place in the file, so there can
+     * be no more of them than bytes in the file.  This bounds what
+     * is allocated below before the rest of the cache is read.
+     */
+    ok = (fread(&h, sizeof(h), 1, f) == 1 &&
+        memcmp(h.magic, lx_id.magic, sizeof(h.magic)) == 0 &&
+        h.posize == lx_id.posize && h.group == lx_id.group &&
+        h.dev == lx_id.dev && h.ino == lx_id.ino &&
+        h.size == lx_id.size && h.mtime == lx_id.mtime &&
+        h.nstarts >= 0 && h.nstarts <= h.size &&
+        (h.nstarts + LX_GROUP - 1) / LX_GROUP < INT_MAX &&
+        h.ngroups == (h.nstarts + LX_GROUP - 1) / LX_GROUP &&
+        h.ndeltas <= (size_t) h.size && h.last <= h.size);
+    groups = NULL;
+    deltas = NULL;
+    if (ok)
+    {
+        groups = (struct lx_group *) calloc(h.ngroups + 1, sizeof(struct lx_group));
+        deltas = (unsigned char *) calloc(h.ndeltas + 1, sizeof(unsigned char));
+        ok = (groups != NULL && deltas != NULL &&
+            fread(groups, sizeof(struct lx_group), h.ngroups, f) == (size_t) h.ngroups &&
+            fread(deltas, sizeof(unsigned char), h.ndeltas, f) == h.ndeltas &&
+            lx_cache_valid(&h, groups, deltas));
+    }
+    fclose(f);
+    if (!ok)
+    {
+        if (groups != NULL)
+            free(groups);
+        if (deltas != NULL)
+            free(deltas);
+        return;
+    }
+    lx_groups = groups;
+    lx_ngroups = h.ngroups;
+    lx_agroups = h.ngroups + 1;
+    lx_deltas = deltas;
+    lx_ndeltas = h.ndeltas;
+    lx_adeltas = h.ndeltas + 1;
+    lx_nstarts = h.nstarts;
+    lx_last = h.last;
+    lx_scanned = h.size;
+}
+#endif
+
+/*
+ * Can the line index be used for the current file?
+ */
+    static int
+lx_usable(VOID_PARAM)
+{
+    POSITION len;
+
+    if (!line_index || lx_failed)
+        return (0);
+    if ((ch_getflags() & (CH_CANSEEK|CH_HELPFILE)) != CH_CANSEEK)
+        return (0);
+    len = ch_length();
+    if (len == NULL_POSITION)
+        return (0);
+    if (len < lx_scanned)
+    {
+        /*
+         * The file has shrunk; start over.
+         */
+        clr_linenum();
+    }
+#if LX_CACHE
+    if (!lx_cache_checked)
+        lx_cache_load();
+#endif
+    return (1);
+}
+
+/*
+ * Add a line start to the end of the line index.
+ */
+    static int
+lx_add(pos)
+    POSITION pos;
+{
+    POSITION delta;
+
+    if (lx_nstarts % LX_GROUP == 0)
+    {
+        if (lx_ngroups >= lx_agroups)
+        {
+            int n = (lx_agroups == 0) ? 64 : 2 * lx_agroups;
+            struct lx_group *g = (struct lx_group *) calloc(n, sizeof(struct lx_group));
+            if (g == NULL)
+                return (-1);
+            if (lx_groups != NULL)
+            {
+                memcpy(g, lx_groups, lx_ngroups * sizeof(struct lx_group));
+                free(lx_groups);
+            }
+            lx_groups = g;
+            lx_agroups = n;
+        }
+        lx_groups[lx_ngroups].pos = pos;
+        lx_groups[lx_ngroups].offset = lx_ndeltas;
+        lx_ngroups++;
+    } else
+    {
+        /*
+         * Store the distance from the previous start,
+         * 7 bits per byte, with the high bit set on all but the last.
+         */
+        if (lx_ndeltas + 10 > lx_adeltas)
+        {
+            size_t n = (lx_adeltas == 0) ? 4096 : 2 * lx_adeltas;
+            unsigned char *d = (unsigned char *) calloc(n, sizeof(unsigned char));
+            if (d == NULL)
+                return (-1);
+            if (lx_deltas != NULL)
+            {
+                memcpy(d, lx_deltas, lx_ndeltas);
+                free(lx_deltas);
+            }
+            lx_deltas = d;
+            lx_adeltas = n;
+        }
+        for (delta = pos - lx_last;  delta >= 0x80;  delta >>= 7)
+            lx_deltas[lx_ndeltas++] = (unsigned char) (delta | 0x80);
+        lx_deltas[lx_ndeltas++] = (unsigned char) delta;
+    }
+    lx_last = pos;
+    lx_nstarts++;
+    return (0);
+}
+
+/*
+ * Decode one distance from the line index.
+ */
+    static POSITION
+lx_delta(pp)
+    unsigned char **pp;
+{
+    unsigned char *p = *pp;
+    POSITION delta = 0;
+    int shift = 0;
+
+    do
+    {
+        delta |= (POSITION) (*p & 0x7F) << shift;
+        shift += 7;
+    } while (*p++ & 0x80);
+    *pp = p;
+    return (delta);
+}
+
+/*
+ * Read more of the file into the line index, until it covers
+ * the given position and holds at least the given number of starts,
+ * or the end of the file is reached.
+ * Return -1 if interrupted or out of memory.
+ */
+    static int
+lx_extend(pos, nstarts)
+    POSITION pos;
+    LINENUM nstarts;
+{
+    POSITION len;
+    unsigned char *p;
+    unsigned char *q;
+    unsigned char *end;
+    int n;
+    int ngroups;
+    size_t ndeltas;
+    LINENUM nstarts0;
+    POSITION last;
+
+    len = ch_length();
+    if (lx_scanned >= len || (lx_scanned >= pos && lx_nstarts >= nstarts))
+        return (0);
+    if (ch_seek(lx_scanned))
+        return (-1);
+    while (lx_scanned < len && (lx_scanned < pos || lx_nstarts < nstarts))
+    {
+        n = ch_forw_span(&p);
+        if (n == 0)
+            break;
+        if (n > LX_CHUNK)
+            n = LX_CHUNK;
+        if (n > len - lx_scanned)
+            n = (int) (len - lx_scanned);
+        end = p + n;
+        ngroups = lx_ngroups;
+        ndeltas = lx_ndeltas;
+        nstarts0 = lx_nstarts;
+        last = lx_last;
+        for (q = p;  (q = (unsigned char *) memchr(q, '\n', end - q)) != NULL;  )
+        {
+            q++;
+            if (lx_add(lx_scanned + (q - p)) < 0)
+            {
+                lx_failed = 1;
+                return (-1);
+            }
+        }
+        if (ch_span_lost())
+        {
+            /*
+             * The file was truncated under us.  Forget the starts
+             * found in this run and read it again.
+             */
+            lx_ngroups = ngroups;
+            lx_ndeltas = ndeltas;
+            lx_nstarts = nstarts0;
+            lx_last = last;
+            if (ch_seek(lx_scanned))
+                return (-1);
+            continue;
+        }
+        lx_scanned += n;
+#if LX_CACHE
+        lx_cache_dirty = 1;
+#endif
+        ch_skip((POSITION) n);
+        if (ABORT_SIGS())
+            return (-1);
+        longish();
+    }
+    return (0);
+}
+
+/*
+ * Count the line starts in the index which are at or before a position.
+ */
+    static LINENUM
+lx_count(pos)
+    POSITION pos;
+{
+    int lo, hi, mid;
+    LINENUM count;
+    LINENUM end;
+    POSITION spos;
+    POSITION npos;
+    unsigned char *p;
+
+    if (lx_ngroups == 0 || lx_groups[0].pos > pos)
+        return (0);
+    /*
+     * Find the last checkpoint at or before pos.
+     */
+    lo = 0;
+    hi = lx_ngroups - 1;
+    while (lo < hi)
+    {
+        mid = (lo + hi + 1) / 2;
+        if (lx_groups[mid].pos <= pos)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+    count = (LINENUM) lo * LX_GROUP + 1;
+    end = count - 1 + LX_GROUP;
+    if (end > lx_nstarts)
+        end = lx_nstarts;
+    spos = lx_groups[lo].pos;
+    p = &lx_deltas[lx_groups[lo].offset];
+    for (;  count < end;  count++)
+    {
+        npos = spos + lx_delta(&p);
+        if (npos > pos)
+            break;
+        spos = npos;
+    }
+    return (count);
+}
+
+/*
+ * Return the position of the n'th line start in the index (from 0).
+ */
+    static POSITION
+lx_start(n)
+    LINENUM n;
+{
+    struct lx_group *g = &lx_groups[n / LX_GROUP];
+    unsigned char *p = &lx_deltas[g->offset];
+    POSITION spos = g->pos;
+
+    for (n %= LX_GROUP;  n > 0;  n--)
+        spos += lx_delta(&p);
+    return (spos);
+}
+
+/*
+ * Save the line index of the current file in its cache file,
+ * if the index is complete and has not already been saved.
+ */
+    public void
+save_line_index(VOID_PARAM)
+{
+#if LX_CACHE
+    struct lx_header h;
+    char *name;
+    char *tempname;
+    FILE *f;
+    int ok;
+
+    if (!lx_cache_known || !lx_cache_dirty || lx_failed || lx_scanned != lx_id.size)
+        return;
+    lx_cache_dirty = 0;
+    name = lx_cache_name();
+    if (name == NULL)
+        return;
+    h = lx_id;
+    h.nstarts = lx_nstarts;
+    h.last = lx_last;
+    h.ngroups = lx_ngroups;
+    h.ndeltas = lx_ndeltas;
+    tempname = make_tempname(name);
+    f = fopen(tempname, "wb");
+    if (f != NULL)
+    {
+        make_file_private(f);
+        ok = (fwrite(&h, sizeof(h), 1, f) == 1 &&
+            fwrite(lx_groups, sizeof(struct lx_group), lx_ngroups, f) == (size_t) lx_ngroups &&
+            fwrite(lx_deltas, sizeof(unsigned char), lx_ndeltas, f) == lx_ndeltas);
+        if (fclose(f) != 0)
+            ok = 0;
+        if (ok)
+        {
+#if MSDOS_COMPILER==WIN32C
+            remove(name);
+#endif
+            rename(tempname, name);
+        } else
+            remove(tempname);
+    }
+    free(tempname);
+    free(name);
+#endif
+}
+
 /*
  * Find the line number associated with a given position.
  * Return 0 if we can't figure it out.
@@ -272,6 +826,7 @@ find_linenum(pos)
     struct linenum_info *p;
     LINENUM linenum;
     POSITION cpos;
+    POSITION len;
 
     if (!linenums)
         /*
@@ -289,6 +844,33 @@ find_linenum(pos)
          */
         return (1);
 
+    if (lx_usable())
+    {
+        /*
+         * The line number is one more than the number of
+         * line starts before pos.  If the last line has no
+         * newline, the end of the file starts another line.
+         */
+        len = ch_length();
+        if (pos > len)
+            return (0);
+#if HAVE_TIME
+        startime = get_time();
+#endif
+        loopcount = 0;
+        if (lx_extend(pos, (LINENUM) 0) < 0)
+        {
+            abort_long();
+            loopcount = 0;
+            return (0);
+        }
+        loopcount = 0;
+        linenum = lx_count(pos) + 1;
+        if (pos == len && len > lx_last)
+            linenum++;
+        return (linenum);
+    }
+
     /*
      * Find the entry nearest to the position we want.
      */
@@ -385,6 +967,7 @@ find_pos(linenum)
 {
     struct linenum_info *p;
     POSITION cpos;
+    POSITION len;
     LINENUM clinenum;
 
     if (linenum <= 1)
@@ -393,6 +976,30 @@ find_pos(linenum)
          */
         return (ch_zero());
 
+    if (lx_usable())
+    {
+        /*
+         * Line N starts at index entry N-2.
+         */
+#if HAVE_TIME
+        startime = get_time();
+#endif
+        loopcount = 0;
+        if (lx_extend((POSITION) 0, linenum - 1) < 0)
+        {
+            loopcount = 0;
+            return (NULL_POSITION);
+        }
+        loopcount = 0;
+        if (linenum - 1 <= lx_nstarts)
+            return (lx_start(linenum - 2));
+        len = ch_length();
+        if (linenum - 1 == lx_nstarts + 1 && len > lx_last)
+            /* The start of a last line with no newline. */
+            return (len);
+        return (NULL_POSITION);
+    }
+
     /*
      * Find the entry nearest to the line number we want.
      */
@@ -484,6 +1091,13 @@ scan_eof(VOID_PARAM)
     if (ch_seek(0))
         return;
     ierror("Determining length of file", NULL_PARG);
+    if (lx_usable())
+    {
+        loopcount = -1;
+        (void) lx_extend(ch_length(), (LINENUM) 0);
+        loopcount = 0;
+        return;
+    }
     while (pos != NULL_POSITION)
     {
         /* For efficiency, only add one every 256 line numbers. */
@@ -491,8 +1105,121 @@ scan_eof(VOID_PARAM)
             add_lnum(linenum, pos);
         pos = forw_raw_line(pos, (char **)NULL, (int *)NULL);
         if (ABORT_SIGS())
-            break;
+            return;
+    }
+    sa_done = 1;
+}
+
+/*
+ * Should lines be counted ahead while waiting for a command?
+ * Only files which can be read to the end without waiting qualify.
+ */
+    static int
+sa_usable(VOID_PARAM)
+{
+    if (!scan_ahead || !linenums || ignore_eoi)
+        return (0);
+    if ((ch_getflags() & (CH_CANSEEK|CH_HELPFILE)) != CH_CANSEEK)
+        return (0);
+    return (ch_length() != NULL_POSITION);
+}
+
+/*
+ * Is the current file still being counted by scan_ahead_step?
+ * If so, set the number of bytes and lines counted so far.
+ */
+    public int
+scan_ahead_progress(pbytes, plines)
+    POSITION *pbytes;
+    LINENUM *plines;
+{
+    POSITION len;
+
+    if (!sa_usable())
+        return (0);
+    len = ch_length();
+    if (lx_usable())
+    {
+        if (lx_scanned >= len)
+            return (0);
+        *pbytes = lx_scanned;
+        *plines = lx_nstarts;
+        return (1);
     }
+    if (sa_done || sa_pos >= len)
+        return (0);
+    *pbytes = sa_pos;
+    *plines = sa_lines;
+    return (1);
+}
+
+/*
+ * Count another slice of lines in the current file,
+ * in the time between commands.
+ * Return nonzero if there is more to do.
+ */
+    public int
+scan_ahead_step(VOID_PARAM)
+{
+    POSITION len;
+    POSITION pos;
+    POSITION npos;
+    POSITION end;
+    POSITION save_pos;
+    int more = 1;
+
+    if (!sa_usable())
+        return (0);
+    len = ch_length();
+    save_pos = ch_tell();
+    loopcount = -1;
+    if (lx_usable())
+    {
+        end = lx_scanned + SA_SLICE;
+        if (lx_extend(end, (LINENUM) 0) < 0 || lx_scanned >= len)
+            more = 0;
+    } else
+    {
+        /*
+         * Start from the furthest line number already known;
+         * find_linenum may have got beyond sa_pos.
+         */
+        if (anchor.prev != &anchor && anchor.prev->pos > sa_pos)
+        {
+            sa_pos = anchor.prev->pos;
+            sa_lines = anchor.prev->line - 1;
+        }
+        end = sa_pos + SA_SLICE;
+        pos = sa_pos;
+        if (sa_done || pos >= len || ch_seek(pos))
+            more = 0;
+        while (more && pos < end)
+        {
+            npos = forw_raw_line(pos, (char **)NULL, (int *)NULL);
+            if (ABORT_SIGS())
+            {
+                /*
+                 * The line may have been cut short by the interrupt;
+                 * leave it to be counted next time.
+                 */
+                more = 0;
+                break;
+            }
+            if ((sa_lines++ % 256) == 0)
+                add_lnum(sa_lines, pos);
+            pos = npos;
+            if (pos == NULL_POSITION || pos >= len)
+            {
+                sa_done = 1;
+                more = 0;
+            } else
+                sa_pos = pos;
+        }
+    }
+    loopcount = 0;
+    if (save_pos != NULL_POSITION)
+        (void) ch_seek(save_pos);
+    return (more);
 }
 
 /*
@@ -64,6 +64,10 @@ extern int      errmsgs;
 extern int      redraw_on_quit;
 extern int      term_init_done;
 extern int      first_time;
+extern int      autobuf;
+extern int      print_mode;
+extern int      print_follow;
+extern char *   grep_pattern;
 
 /*
  * Entry point.
@@ -219,18 +223,31 @@ main(argc, argv)
     /*
      * Set up terminal, etc.
      */
-    if (!is_tty)
+    if (!is_tty || print_mode || print_follow || grep_pattern != NULL)
     {
         /*
-         * Output is not a tty.
-         * Just copy the input file(s) to output.
+         * Output is not a tty, or --print or --grep was given.
+         * Just copy the input file(s) to output,
+         * or only the lines which match the --grep pattern.
          */
+        if (grep_pattern != NULL && set_grep_pattern(grep_pattern) < 0)
+            quit(QUIT_ERROR);
+        /*
+         * The input is read only once, from start to end,
+         * so there is no need to keep all of a pipe in memory.
+         */
+        autobuf = OPT_OFF;
         set_output(1); /* write to stdout */
         SET_BINARY(1);
         if (edit_first() == 0)
         {
             do {
-                cat_file();
+                if (grep_pattern != NULL || print_follow)
+                    /* Only the last file is followed. */
+                    grep_file(print_follow &&
+                        next_ifile(curr_ifile) == NULL_IFILE);
+                else
+                    cat_file();
             } while (edit_next(1) == 0);
         }
         quit(QUIT_OK);
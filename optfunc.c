@@ -68,6 +68,7 @@ extern char *namelogfile;
 extern int force_logfile;
 extern int logfile;
 #endif
+public char *grep_pattern = NULL;
 #if TAGS
 public char *tagoption = NULL;
 extern char *tags;
@@ -439,6 +440,35 @@ opt_p(type, s)
     }
 }
 
+/*
+ * Handler for the --grep option.
+ */
+    public void
+opt_grep(type, s)
+    int type;
+    char *s;
+{
+    PARG parg;
+
+    switch (type)
+    {
+    case INIT:
+        if (grep_pattern != NULL)
+            free(grep_pattern);
+        grep_pattern = (*s == '\0') ? NULL : save(s);
+        break;
+    case QUERY:
+        if (grep_pattern == NULL)
+        {
+            error("No grep pattern", NULL_PARG);
+            break;
+        }
+        parg.p_string = grep_pattern;
+        error("Grep pattern: %s", &parg);
+        break;
+    }
+}
+
 /*
  * Handler for -P option.
  */
@@ -624,6 +654,8 @@ color_from_namechar(namechar)
     case 'R': return AT_COLOR_RSCROLL;
     case 'S': return AT_COLOR_SEARCH;
     case 'W': case 'A': return AT_COLOR_ATTN;
+    case '1': case '2': case '3': case '4':
+        return AT_COLOR_HIGHLIGHT(namechar - '0');
     case 'n': return AT_NORMAL;
     case 's': return AT_STANDOUT;
     case 'd': return AT_BOLD;
@@ -269,6 +269,16 @@ scan_option(s)
              */
             while (*s == ' ')
                 s++;
+            if (o->otype & WHOLE_STRING)
+            {
+                /*
+                 * Take the rest of the argument as it is,
+                 * even an END_OPTION_STRING character.
+                 */
+                str = save(s);
+                s += strlen(s);
+                break;
+            }
             s = optstring(s, &str, printopt, o->odesc[1]);
             if (s == NULL)
                 return;
@@ -23,6 +23,7 @@
 #define HL_REPAINT      0200    /* Repaint hilites after toggling option */
 #define NO_QUERY        0400    /* Option cannot be queried with "_" cmd */
 #define INIT_HANDLER    01000   /* Call option handler function at startup */
+#define WHOLE_STRING    02000   /* String option takes the rest of its argument */
 
 #define OTYPE           (BOOL|TRIPLE|NUMBER|STRING|NOVAR)
 
@@ -71,6 +71,15 @@ public int nonum_headers;       /* Don't give headers line numbers */
 public int redraw_on_quit;      /* Redraw last screen after term deinit */
 public int def_search_type;     /* */
 public int exit_F_on_close;     /* Exit F command when input closes */
+public int line_index;          /* Keep an index of every line start */
+public int search_threads;      /* Number of threads for forward searches */
+public int scan_ahead;          /* Count lines while waiting for a command */
+public int block_size;          /* Block size for new files (K); 0 to choose */
+public int total_bufspace;      /* Max buffer space for all files (K) */
+public int print_mode;          /* Write the input to stdout, don't page it */
+public int print_follow;        /* Likewise, and follow the last file */
+public int no_screen_diff;      /* Always redraw the whole screen */
+public int follow_rate;         /* Max repaints per second in F mode */
 #if HILITE_SEARCH
 public int hilite_search;       /* Highlight matched search patterns? */
 #endif
@@ -138,6 +147,7 @@ static struct optname follow_optname = { "follow-name",          NULL };
 static struct optname use_backslash_optname = { "use-backslash", NULL };
 static struct optname rscroll_optname = { "rscroll", NULL };
 static struct optname nohistdups_optname = { "no-histdups",      NULL };
+static struct optname noscreendiff_optname = { "no-screen-diff", NULL };
 static struct optname mousecap_optname = { "mouse",              NULL };
 static struct optname wheel_lines_optname = { "wheel-lines",     NULL };
 static struct optname perma_marks_optname = { "save-marks",      NULL };
@@ -152,6 +162,15 @@ static struct optname nonum_headers_optname = { "no-number-headers", NULL };
 static struct optname redraw_on_quit_optname = { "redraw-on-quit", NULL };
 static struct optname search_type_optname = { "search-options", NULL };
 static struct optname exit_F_on_close_optname = { "exit-follow-on-close", NULL };
+static struct optname line_index_optname = { "line-index",       NULL };
+static struct optname search_threads_optname = { "search-threads", NULL };
+static struct optname scan_ahead_optname = { "scan-ahead",       NULL };
+static struct optname block_size_optname = { "block-size",       NULL };
+static struct optname total_bufspace_optname = { "total-buffers", NULL };
+static struct optname grep_optname = { "grep",                   NULL };
+static struct optname print_mode_optname = { "print",            NULL };
+static struct optname print_follow_optname = { "print-follow",   NULL };
+static struct optname follow_rate_optname = { "follow-rate",    NULL };
 #if LESSTEST
 static struct optname ttyin_name_optname = { "tty",              NULL };
 static struct optname rstat_optname  = { "rstat",                NULL };
@@ -511,6 +530,14 @@ static struct loption option[] =
             NULL
         }
     },
+    { OLETTER_NONE, &noscreendiff_optname,
+        BOOL, OPT_OFF, &no_screen_diff, NULL,
+        {
+            "Redraw only the screen lines that changed",
+            "Redraw the whole screen",
+            NULL
+        }
+    },
     { OLETTER_NONE, &mousecap_optname,
         TRIPLE, OPT_OFF, &mousecap, opt_mousecap,
         {
@@ -623,6 +650,78 @@ static struct loption option[] =
             NULL
         }
     },
+    { OLETTER_NONE, &line_index_optname,
+        BOOL, OPT_OFF, &line_index, NULL,
+        {
+            "Don't index line numbers",
+            "Index line numbers",
+            NULL
+        }
+    },
+    { OLETTER_NONE, &search_threads_optname,
+        NUMBER, 1, &search_threads, NULL,
+        {
+            "Search threads: ",
+            "Forward searches use up to %d threads",
+            NULL
+        }
+    },
+    { OLETTER_NONE, &scan_ahead_optname,
+        BOOL, OPT_OFF, &scan_ahead, NULL,
+        {
+            "Don't count lines between commands",
+            "Count lines between commands",
+            NULL
+        }
+    },
+    { OLETTER_NONE, &block_size_optname,
+        NUMBER, 0, &block_size, NULL,
+        {
+            "Block size for new files (K, 0 to choose): ",
+            "Block size for new files: %dK (0 = chosen for each file)",
+            NULL
+        }
+    },
+    { OLETTER_NONE, &total_bufspace_optname,
+        NUMBER, -1, &total_bufspace, NULL,
+        {
+            "Max buffer space for all files (K): ",
+            "Max buffer space for all files: %dK",
+            NULL
+        }
+    },
+    { OLETTER_NONE, &grep_optname,
+        STRING|NO_TOGGLE|WHOLE_STRING, 0, NULL, opt_grep,
+        {
+            "Grep pattern: ",
+            NULL,
+            NULL
+        }
+    },
+    { OLETTER_NONE, &print_mode_optname,
+        BOOL|NO_TOGGLE, OPT_OFF, &print_mode, NULL,
+        {
+            "Page the input",
+            "Write the input to standard output",
+            NULL
+        }
+    },
+    { OLETTER_NONE, &print_follow_optname,
+        BOOL|NO_TOGGLE, OPT_OFF, &print_follow, NULL,
+        {
+            "Don't follow the input when writing it",
+            "Write the input to standard output and follow it",
+            NULL
+        }
+    },
+    { OLETTER_NONE, &follow_rate_optname,
+        NUMBER, 60, &follow_rate, NULL,
+        {
+            "Max repaints per second in F mode (0 for no limit): ",
+            "F mode repaints at most %d times per second (0 = no limit)",
+            NULL
+        }
+    },
 #if LESSTEST
     { OLETTER_NONE, &ttyin_name_optname,
         STRING|NO_TOGGLE, 0, NULL, opt_ttyin_name,
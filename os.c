@@ -68,6 +68,7 @@ static jmp_buf read_label;
 extern int sigs;
 extern int ignore_eoi;
 extern int exit_F_on_close;
+extern int follow_rate;
 #if !MSDOS_COMPILER
 extern int tty;
 #endif
@@ -143,7 +144,6 @@ start:
         return (READ_INTR);
     }
 
-    flush();
     reading = 1;
 #if MSDOS_COMPILER==DJGPPC
     if (isatty(fd))
@@ -166,10 +166,11 @@ start:
     }
 #endif
 #if USE_POLL
-    if (ignore_eoi && fd != tty)
+    if (ignore_eoi && (fd != tty || !interactive()))
     {
         int close_events = exit_F_on_close ? POLLERR|POLLHUP : POLLERR;
-        if (poll_events(tty, POLLIN) && getchr() == CONTROL('X'))
+        /* Without a screen (see --print) there is no tty to read. */
+        if (interactive() && poll_events(tty, POLLIN) && getchr() == CONTROL('X'))
         {
             sigs |= S_INTERRUPT;
             reading = 0;
@@ -235,6 +236,58 @@ start:
     return (n);
 }
 
+/*
+ * Is there terminal input waiting to be read?
+ * Say there is if that cannot be told.
+ */
+    public int
+tty_pending(VOID_PARAM)
+{
+#if USE_POLL
+    return (poll_events(tty, POLLIN) != 0);
+#else
+    return (1);
+#endif
+}
+
+/*
+ * Is there input waiting to be read from fd?
+ * Say there is not if that cannot be told.
+ */
+    public int
+fd_pending(fd)
+    int fd;
+{
+#if USE_POLL
+    return (poll_events(fd, POLLIN) != 0);
+#else
+    return (0);
+#endif
+}
+
+/*
+ * Wait until there is terminal input, or data to be read from fd.
+ * Return nonzero if there is terminal input, or if that cannot be told.
+ */
+    public int
+tty_wait(fd)
+    int fd;
+{
+#if USE_POLL
+    struct pollfd poller[2];
+
+    poller[0].fd = tty;
+    poller[0].events = POLLIN;
+    poller[1].fd = fd;
+    poller[1].events = POLLIN;
+    if (poll(poller, 2, -1) <= 0 || poller[0].revents != 0)
+        return (1);
+    return (0);
+#else
+    return (1);
+#endif
+}
+
 /*
  * Interrupt a pending iread().
  */
@@ -244,6 +297,34 @@ intread(VOID_PARAM)
     LONG_JUMP(read_label, 1);
 }
 
+/*
+ * Wait while following a file (see ignore_eoi), for the time
+ * between two repaints as set by --follow-rate, or until there
+ * is terminal input or a signal.
+ */
+    public void
+follow_wait(VOID_PARAM)
+{
+    int ms = 2;
+#if USE_POLL
+    struct pollfd poller;
+#endif
+
+    if (follow_rate > 0)
+        ms = (follow_rate < 1000) ? 1000 / follow_rate : 1;
+#if USE_POLL
+    if (interactive())
+    {
+        poller.fd = tty;
+        poller.events = POLLIN;
+        poller.revents = 0;
+        (void) poll(&poller, 1, ms);
+        return;
+    }
+#endif
+    sleep_ms(ms);
+}
+
 /*
  * Return the current time.
  */
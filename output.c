@@ -26,11 +26,16 @@ public int final_attr;
 public int at_prompt;
 
 extern int sigs;
-extern int sc_width;
+extern int sc_width, sc_height;
 extern int so_s_width, so_e_width;
 extern int screen_trashed;
 extern int is_tty;
 extern int oldbot;
+extern int auto_wrap, ignaw;
+extern int can_goto_line;
+extern int ctldisp;
+extern int header_cols;
+extern int no_screen_diff;
 
 #if MSDOS_COMPILER==WIN32C || MSDOS_COMPILER==BORLANDC || MSDOS_COMPILER==DJGPPC
 extern int ctldisp;
@@ -46,43 +51,616 @@ extern int vt_enabled;
 #endif
 
 /*
- * Display the line which is in the line buffer.
+ * A copy of what put_line has written on each line of the screen
+ * above the bottom line.
+ * A repaint may be done as a "screen diff": the lines are drawn
+ * into new_lines rather than onto the screen, and then only the
+ * parts of them which differ from what the screen shows are written.
  */
-    public void
-put_line(VOID_PARAM)
+struct scr_line
+{
+    char *chars;    /* Chars as they came from gline */
+    int *attrs;     /* Attribute of each char */
+    int len;        /* Number of chars */
+    int size;       /* Room in chars and attrs */
+    int known;      /* Is this what the screen line shows? */
+    int moves;      /* Where it left the cursor; see scr_line_moves */
+};
+
+static struct scr_line *scr_lines = NULL;  /* What the screen shows */
+static struct scr_line *new_lines = NULL;  /* Lines drawn by a screen diff */
+static int scr_nlines = 0;          /* Number of screen lines */
+static int scr_ncols = 0;           /* Screen width when they were kept */
+static int scr_row = -1;            /* Line the cursor is on, -1 if unknown */
+static int in_screen_diff = 0;      /* Drawing into new_lines? */
+static int diff_row = -1;           /* Cursor line while writing a diff */
+static int diff_at_start;           /* Is the cursor at the start of it? */
+static struct scr_line put_buf;     /* The line being put */
+
+/*
+ * Make sure there is a scr_line for each line of the screen.
+ */
+    static void
+scr_alloc(VOID_PARAM)
 {
-    int c;
     int i;
-    int a;
 
-    if (ABORT_SIGS())
+    if (scr_nlines == sc_height && scr_ncols == sc_width)
+        return;
+    /* The screen has changed size; what it shows is not known. */
+    in_screen_diff = 0;
+    scr_row = -1;
+    for (i = 0;  i < scr_nlines;  i++)
     {
-        /*
-         * Don't output if a signal is pending.
-         */
-        screen_trashed = 1;
+        free(scr_lines[i].chars);
+        free(scr_lines[i].attrs);
+        free(new_lines[i].chars);
+        free(new_lines[i].attrs);
+    }
+    if (scr_lines != NULL)
+    {
+        free(scr_lines);
+        free(new_lines);
+    }
+    scr_nlines = sc_height;
+    scr_ncols = sc_width;
+    scr_lines = (struct scr_line *) ecalloc(scr_nlines, sizeof(struct scr_line));
+    new_lines = (struct scr_line *) ecalloc(scr_nlines, sizeof(struct scr_line));
+}
+
+/*
+ * Exchange the contents of two scr_lines.
+ */
+    static void
+scr_swap(a, b)
+    struct scr_line *a;
+    struct scr_line *b;
+{
+    struct scr_line t;
+
+    t = *a;
+    *a = *b;
+    *b = t;
+}
+
+/*
+ * Make sure a scr_line has room for n chars.
+ */
+    static void
+scr_room(sl, n)
+    struct scr_line *sl;
+    int n;
+{
+    int size;
+    char *chars;
+    int *attrs;
+
+    if (n <= sl->size)
         return;
+    for (size = (sl->size > 0) ? sl->size : 256;  size < n;  size *= 2)
+        continue;
+    chars = (char *) ecalloc(size, sizeof(char));
+    attrs = (int *) ecalloc(size, sizeof(int));
+    if (sl->size > 0)
+    {
+        memcpy(chars, sl->chars, sl->len * sizeof(char));
+        memcpy(attrs, sl->attrs, sl->len * sizeof(int));
+        free(sl->chars);
+        free(sl->attrs);
+    }
+    sl->chars = chars;
+    sl->attrs = attrs;
+    sl->size = size;
+}
+
+/*
+ * Copy the line in the line buffer, as gline returns it, into put_buf.
+ */
+    static void
+scr_get_line(VOID_PARAM)
+{
+    int c;
+    int a;
+    int n;
+    char *chars;
+    int *attrs;
+    char *p;
+    struct scr_line *sl = &put_buf;
+
+    sl->len = 0;
+    while ((n = gline_run(sl->len, &chars, &attrs)) > 0)
+    {
+        p = (char *) memchr(chars, '\0', n);
+        if (p != NULL)
+            n = (int) (p - chars);
+        scr_room(sl, sl->len + n);
+        memcpy(&sl->chars[sl->len], chars, n * sizeof(char));
+        memcpy(&sl->attrs[sl->len], attrs, n * sizeof(int));
+        sl->len += n;
+        if (p != NULL)
+            return;
+    }
+    /* Anything else, such as a null line, a char at a time. */
+    for (;  (c = gline(sl->len, &a)) != '\0';  sl->len++)
+    {
+        scr_room(sl, sl->len + 1);
+        sl->chars[sl->len] = (char) c;
+        sl->attrs[sl->len] = a;
     }
+}
 
-    final_attr = AT_NORMAL;
+/*
+ * The number of chars in a line which are displayed,
+ * leaving out the newline (or the space and backspace which
+ * make some terminals wrap) which end it.
+ */
+    static int
+scr_line_end(sl)
+    struct scr_line *sl;
+{
+    int n = sl->len;
 
-    for (i = 0;  (c = gline(i, &a)) != '\0';  i++)
+    if (n > 0 && sl->chars[n-1] == '\n')
+        n--;
+    else if (n > 1 && sl->chars[n-2] == ' ' && sl->chars[n-1] == '\b')
+        n -= 2;
+    return (n);
+}
+
+/*
+ * Does putting a line move the cursor to the start of the next line?
+ * Return -1 if it leaves the cursor at the right edge, where
+ * the next char may or may not start a new line.
+ */
+    static int
+scr_line_moves(sl)
+    struct scr_line *sl;
+{
+    if (scr_line_end(sl) < sl->len)
+        return (1);
+    if (!line_at_edge())
+        return (0);
+    return ((auto_wrap && !ignaw) ? 1 : -1);
+}
+
+/*
+ * Write some of the chars of a line, with their attributes.
+ * Chars are written a run at a time, where a run is a
+ * sequence of chars with the same attribute, so the terminal
+ * is switched to each attribute only once.
+ */
+    static void
+put_chars(sl, start, end)
+    struct scr_line *sl;
+    int start;
+    int end;
+{
+    int i;
+    int j;
+    int c;
+    int a;
+
+    for (i = start;  i < end;  i = j)
     {
+        c = (unsigned char) sl->chars[i];
+        a = sl->attrs[i];
         at_switch(a);
         final_attr = a;
+        j = i + 1;
         if (c == '\b')
             putbs();
-        else
+        else if (c == '\n')
             putchr(c);
+        else
+        {
+            while (j < end && sl->attrs[j] == a &&
+                   sl->chars[j] != '\b' && sl->chars[j] != '\n')
+                j++;
+            putbytes(&sl->chars[i], j - i);
+        }
     }
-
     at_exit();
 }
 
-static char obuf[OUTBUF_SIZE];
-static char *ob = obuf;
+/*
+ * Forget what is on the screen.
+ */
+    public void
+scr_forget(VOID_PARAM)
+{
+    int i;
+
+    for (i = 0;  i < scr_nlines;  i++)
+        scr_lines[i].known = 0;
+    scr_row = -1;
+}
+
+/*
+ * Note that the screen has been cleared and the cursor homed.
+ */
+    public void
+scr_clear(VOID_PARAM)
+{
+    int i;
+
+    in_screen_diff = 0;
+    scr_alloc();
+    for (i = 0;  i < scr_nlines;  i++)
+    {
+        scr_lines[i].len = 0;
+        scr_lines[i].known = 1;
+    }
+    scr_row = 0;
+}
+
+/*
+ * Note that the cursor is moving to the start of a screen line.
+ * Return TRUE if it need not really move, because the line is
+ * being drawn by a screen diff.
+ */
+    public int
+scr_move(row)
+    int row;
+{
+    if (in_screen_diff && row >= 0 && row < scr_nlines - 1)
+    {
+        scr_row = row;
+        return (TRUE);
+    }
+    end_screen_diff();
+    scr_row = row;
+    return (FALSE);
+}
+
+/*
+ * Note that a blank line is being added at the top of the screen,
+ * pushing the other lines down.
+ * Return TRUE if it need not really be added,
+ * because the screen is being drawn by a screen diff.
+ */
+    public int
+scr_add_line(VOID_PARAM)
+{
+    struct scr_line *lines = in_screen_diff ? new_lines : scr_lines;
+    int i;
+
+    if (scr_row != 0)
+    {
+        /* Only a line added at the top is followed. */
+        end_screen_diff();
+        scr_forget();
+        return (FALSE);
+    }
+    for (i = scr_nlines - 2;  i > 0;  i--)
+        scr_swap(&lines[i], &lines[i-1]);
+    lines[0].len = 0;
+    lines[0].known = 1;
+    scr_row = 0;
+    return (in_screen_diff);
+}
+
+/*
+ * Note that the rest of the cursor's line is being cleared.
+ * Return TRUE if it need not really be cleared,
+ * because the line is being drawn by a screen diff.
+ */
+    public int
+scr_clear_eol(VOID_PARAM)
+{
+    if (scr_row < 0 || scr_row >= scr_nlines - 1)
+        return (FALSE);
+    if (in_screen_diff)
+    {
+        /* The cursor is always at the start of the line here. */
+        new_lines[scr_row].len = 0;
+        return (TRUE);
+    }
+    /* We don't know which column the cursor is in. */
+    scr_lines[scr_row].known = 0;
+    return (FALSE);
+}
+
+/*
+ * Keep the line just put in put_buf, as what is on the cursor's line.
+ */
+    static void
+scr_put_line(VOID_PARAM)
+{
+    int moves;
+    int i;
+
+    scr_alloc();
+    if (ctldisp == OPT_ON || scr_row < 0)
+    {
+        /*
+         * Raw control chars may have done anything to the screen,
+         * and a line put who knows where may have scrolled it.
+         */
+        scr_forget();
+        return;
+    }
+    moves = put_buf.moves = scr_line_moves(&put_buf);
+    if (in_screen_diff)
+    {
+        scr_swap(&new_lines[scr_row], &put_buf);
+        new_lines[scr_row].known = 1;
+    } else if (scr_row == scr_nlines - 1)
+    {
+        /*
+         * A line put on the bottom line (other than the prompt)
+         * scrolls the screen up.
+         */
+        if (moves == 0)
+            return;
+        for (i = 0;  i < scr_nlines - 2;  i++)
+            scr_swap(&scr_lines[i], &scr_lines[i+1]);
+        scr_swap(&scr_lines[scr_nlines - 2], &put_buf);
+        scr_lines[scr_nlines - 2].known = 1;
+        if (moves < 0)
+            scr_row = -1;
+        return;
+    } else
+    {
+        scr_swap(&scr_lines[scr_row], &put_buf);
+        /* A line which does not reach the edge may leave old chars after it. */
+        scr_lines[scr_row].known = (moves != 0);
+    }
+    if (moves > 0)
+        scr_row++;
+    else if (moves < 0)
+        scr_row = -1;
+}
+
+/*
+ * Start drawing the whole screen as a screen diff.
+ * Return FALSE if this can't be done; the screen should then
+ * be cleared or scrolled as usual.
+ * A trashed screen is redrawn in full.
+ */
+    public int
+begin_screen_diff(VOID_PARAM)
+{
+    int i;
+
+#if MSDOS_COMPILER
+    return (FALSE);
+#else
+    if (no_screen_diff || !can_goto_line || !interactive() ||
+        ctldisp == OPT_ON || header_cols > 0)
+        return (FALSE);
+    if (screen_trashed)
+        scr_forget();
+    scr_alloc();
+    for (i = 0;  i < scr_nlines;  i++)
+    {
+        new_lines[i].len = 0;
+        new_lines[i].known = 1;
+    }
+    in_screen_diff = 1;
+    scr_row = 0;
+    return (TRUE);
+#endif
+}
+
+/*
+ * Is a char one which takes one column and changes no terminal state?
+ */
+#define scr_plain(c, a) ((c) >= ' ' && (c) < 0x7f && !((a) & AT_ANSI))
+
+/*
+ * The number of newlines which would move the cursor
+ * to the start of a screen line, or -1 if they can't.
+ */
+    static int
+diff_newlines(row)
+    int row;
+{
+    if (diff_row < 0 || diff_row > row)
+        return (-1);
+    if (diff_row == row)
+        return (diff_at_start ? 0 : -1);
+    return (row - diff_row);
+}
+
+/*
+ * Move the cursor to a column of a screen line while writing a diff.
+ */
+    static void
+diff_goto(row, col)
+    int row;
+    int col;
+{
+    int n = diff_newlines(row);
+
+    if (col == 0 && n >= 0 && n <= goto_col_cost(row, 0))
+    {
+        while (--n >= 0)
+            putchr('\n');
+    } else
+        goto_col(row, col);
+    scr_row = diff_row = row;
+    diff_at_start = (col == 0);
+}
+
+/*
+ * How many chars at the start of a screen line are the same
+ * in a screen diff as on the screen?
+ * Only a part which we know the width of is counted.
+ * Return -1 if the whole line is the same.
+ */
+    static int
+scr_same_chars(row)
+    int row;
+{
+    struct scr_line *old = &scr_lines[row];
+    struct scr_line *new = &new_lines[row];
+    int old_end = scr_line_end(old);
+    int new_end = scr_line_end(new);
+    int col = 0;
+
+    if (!old->known)
+        return (0);
+    if (old->len == new->len &&
+        memcmp(old->chars, new->chars, old->len * sizeof(char)) == 0 &&
+        memcmp(old->attrs, new->attrs, old->len * sizeof(int)) == 0)
+        return (-1);
+    while (col < old_end && col < new_end &&
+           old->chars[col] == new->chars[col] &&
+           old->attrs[col] == new->attrs[col] &&
+           scr_plain(old->chars[col], old->attrs[col]))
+        col++;
+    return (col);
+}
+
+/*
+ * Bring one line of the screen up to date with a screen diff.
+ */
+    static void
+scr_update_line(row)
+    int row;
+{
+    struct scr_line *old = &scr_lines[row];
+    struct scr_line *new = &new_lines[row];
+    int old_end = scr_line_end(old);
+    int new_end = scr_line_end(new);
+    int col;
+
+    col = scr_same_chars(row);
+    if (col < 0)
+        return;
+    if (old->known)
+    {
+        /* Writing the chars again may be cheaper than moving past them. */
+        if (col > 0)
+        {
+            int n = diff_newlines(row);
+            if (n < 0)
+                n = goto_col_cost(row, 0);
+            if (n + col <= goto_col_cost(row, col))
+                col = 0;
+        }
+    }
+    diff_goto(row, col);
+    if (!old->known || old_end > col)
+        clear_eol();
+    put_chars(new, col, new_end);
+    if (new_end < new->len || new->len == 0 || new->moves == 0)
+        /* The cursor is still on this line. */
+        diff_at_start = (new_end == 0);
+    else if (new->moves > 0 && row + 1 < scr_nlines)
+    {
+        /* It has wrapped to the start of the next one. */
+        diff_row = row + 1;
+        diff_at_start = TRUE;
+    } else
+        diff_row = -1;
+    scr_swap(old, new);
+    old->known = 1;
+}
+
+/*
+ * Finish a screen diff: write the changes to the screen.
+ */
+    public void
+end_screen_diff(VOID_PARAM)
+{
+    int row;
+    int end_row;
+    int same;
+    int clears;
+
+    if (!in_screen_diff)
+        return;
+    in_screen_diff = 0;
+    end_row = scr_row;
+    diff_row = -1;
+    /*
+     * If little of the screen is staying the same,
+     * it is cheaper to clear it than to clear each line which changed.
+     */
+    same = 0;
+    clears = 0;
+    for (row = 0;  row < scr_nlines - 1;  row++)
+    {
+        int col = scr_same_chars(row);
+        if (col < 0)
+            same += scr_line_end(&scr_lines[row]);
+        else
+        {
+            same += col;
+            if (!scr_lines[row].known || scr_line_end(&scr_lines[row]) > col)
+                clears++;
+        }
+    }
+    if (same + clear_cost() < clears * clear_eol_cost())
+    {
+        clear();
+        diff_row = 0;
+        diff_at_start = TRUE;
+    }
+    for (row = 0;  row < scr_nlines - 1;  row++)
+        scr_update_line(row);
+    /* Leave the bottom line blank, as clearing or scrolling would. */
+    diff_goto(scr_nlines - 1, 0);
+    clear_eol();
+    if (end_row >= 0 && end_row < scr_nlines - 1)
+        diff_goto(end_row, 0);
+}
+
+/*
+ * Display the line which is in the line buffer.
+ */
+    public void
+put_line(VOID_PARAM)
+{
+    if (ABORT_SIGS())
+    {
+        /*
+         * Don't output if a signal is pending.
+         */
+        screen_trashed = 1;
+        in_screen_diff = 0;
+        scr_forget();
+        return;
+    }
+
+    if (in_screen_diff && (scr_row < 0 || scr_row >= scr_nlines - 1))
+        /* This would scroll; it can't be part of the screen diff. */
+        end_screen_diff();
+
+    scr_get_line();
+    final_attr = AT_NORMAL;
+    if (!in_screen_diff)
+        put_chars(&put_buf, 0, put_buf.len);
+    scr_put_line();
+}
+
+/*
+ * Output is collected in obuf until it is flushed.
+ * obuf starts out as first_obuf, and is made bigger as needed
+ * to hold all the output for a screen (see obuf_room).
+ */
+static char first_obuf[OUTBUF_SIZE];
+static char *obuf = first_obuf;
+static int obuf_size = OUTBUF_SIZE;
+static char *ob = first_obuf;
 static int outfd = 2; /* stderr */
 
+/*
+ * Counts of what has been written, for the %O prompt escape.
+ */
+static POSITION out_bytes = 0;       /* Bytes written */
+static int out_writes = 0;           /* Writes done */
+static POSITION frame_bytes = 0;     /* out_bytes when the screen was last done */
+static int frame_writes = 0;         /* out_writes likewise */
+
+/*
+ * The most bytes per screen position obuf is made to hold.
+ * Room for a few bytes of each char and some attribute changes
+ * is enough for most screens.
+ */
+#define OBUF_CELL_BYTES  16
+
 #if MSDOS_COMPILER==WIN32C || MSDOS_COMPILER==BORLANDC || MSDOS_COMPILER==DJGPPC
     static void
 win_flush(VOID_PARAM)
@@ -366,6 +944,8 @@ flush(VOID_PARAM)
 {
     int n;
 
+    if (in_screen_diff)
+        end_screen_diff();
     n = (int) (ob - obuf);
     if (n == 0)
         return;
@@ -390,8 +970,78 @@ flush(VOID_PARAM)
 #endif
 #endif
 
+    out_writes++;
     if (write(outfd, obuf, n) != n)
+    {
         screen_trashed = 1;
+        scr_forget();
+    } else
+        out_bytes += n;
+}
+
+/*
+ * Make room in obuf for n more chars, plus the one more which
+ * some versions of flush() write.
+ * obuf is made bigger, rather than flushed, until it can hold
+ * a whole screen, so the screen can be written with one write.
+ */
+    static void
+obuf_room(n)
+    int n;
+{
+    int used = (int) (ob - obuf);
+    int max_size = sc_width * sc_height * OBUF_CELL_BYTES;
+    int size;
+    char *nbuf;
+
+    if (used + n < obuf_size)
+        return;
+    for (size = obuf_size;  size <= used + n && size < max_size;  size *= 2)
+        continue;
+    /* Don't use ecalloc; error() would come back here. */
+    if (size > obuf_size && (nbuf = (char *) malloc(size)) != NULL)
+    {
+        memcpy(nbuf, obuf, used);
+        if (obuf != first_obuf)
+            free(obuf);
+        obuf = nbuf;
+        obuf_size = size;
+        ob = obuf + used;
+        if (used + n < obuf_size)
+            return;
+    }
+    flush();
+}
+
+/*
+ * Note that the screen is done: what has been output since the
+ * last time is what it took to bring the screen up to date.
+ */
+    public void
+output_done(VOID_PARAM)
+{
+    flush();
+    frame_bytes = out_bytes;
+    frame_writes = out_writes;
+}
+
+/*
+ * Get the number of bytes and writes used so far to bring
+ * the screen up to date, counting output not yet flushed
+ * as one more write.
+ */
+    public void
+output_counts(pbytes, pwrites)
+    POSITION *pbytes;
+    int *pwrites;
+{
+    int n;
+
+    /* A screen diff which is not done yet has output to come. */
+    end_screen_diff();
+    n = (int) (ob - obuf);
+    *pbytes = out_bytes - frame_bytes + n;
+    *pwrites = out_writes - frame_writes + (n > 0);
 }
 
 /*
@@ -432,6 +1082,8 @@ putchr(c)
         ubuf_len = 0;
     }
 #endif
+    if (in_screen_diff)
+        end_screen_diff();
     clear_bot_if_needed();
 #if MSDOS_COMPILER
     if (c == '\n' && is_tty)
@@ -449,8 +1101,8 @@ putchr(c)
      * Some versions of flush() write to *ob, so we must flush
      * when we are still one char from the end of obuf.
      */
-    if (ob >= &obuf[sizeof(obuf)-1])
-        flush();
+    if (ob >= &obuf[obuf_size-1])
+        obuf_room(1);
     *ob++ = c;
     at_prompt = 0;
     return (c);
@@ -465,6 +1117,38 @@ clear_bot_if_needed(VOID_PARAM)
     clear_bot();
 }
 
+/*
+ * Output a run of bytes, without any translation.
+ */
+    public void
+putbytes(s, n)
+    constant char *s;
+    int n;
+{
+    int room;
+
+    if (in_screen_diff)
+        end_screen_diff();
+    clear_bot_if_needed();
+    obuf_room(n);
+    while (n > 0)
+    {
+        room = (int) (&obuf[obuf_size-1] - ob);
+        if (room <= 0)
+        {
+            flush();
+            continue;
+        }
+        if (room > n)
+            room = n;
+        memcpy(ob, s, room);
+        ob += room;
+        s += room;
+        n -= room;
+    }
+    at_prompt = 0;
+}
+
 /*
  * Output a string.
  */
@@ -669,12 +1353,19 @@ error(fmt, parg)
     clear_eol();
 
     if (col >= sc_width)
+    {
         /*
          * Printing the message has probably scrolled the screen.
          * {{ Unless the terminal doesn't have auto margins,
          *    in which case we just hammered on the right margin. }}
          */
         screen_trashed = 1;
+    }
+    /*
+     * An error often follows output from a shell command or
+     * preprocessor, which may also have scrolled the screen.
+     */
+    scr_forget();
 
     flush();
 }
@@ -692,12 +1383,19 @@ ierror(fmt, parg)
     char *fmt;
     PARG *parg;
 {
+    int col = 0;
+
     at_exit();
     clear_bot();
     at_enter(AT_STANDOUT|AT_COLOR_ERROR);
-    (void) less_printf(fmt, parg);
+    col += so_s_width;
+    col += less_printf(fmt, parg);
     putstr(intr_to_abort);
     at_exit();
+    col += (int) strlen(intr_to_abort) + so_e_width;
+    if (col >= sc_width)
+        /* The message has probably scrolled the screen. */
+        scr_forget();
     flush();
     need_clr = 1;
 }
@@ -717,14 +1415,17 @@ query(fmt, parg)
     if (interactive())
         clear_bot();
 
-    (void) less_printf(fmt, parg);
+    col += less_printf(fmt, parg);
     c = getchr();
 
     if (interactive())
     {
         lower_left();
         if (col >= sc_width)
+        {
             screen_trashed = 1;
+            scr_forget();
+        }
         flush();
     } else
     {
@@ -12,18 +12,19 @@
  */
 
 #include "less.h"
+#include "charset.h"
 
-extern int caseless;
-extern int is_caseless;
 extern int utf_mode;
 
 /*
  * Compile a search pattern, for future use by match_pattern.
+ * If caseless is set, the pattern ignores case.
  */
     static int
-compile_pattern2(pattern, search_type, comp_pattern, show_error)
+compile_pattern2(pattern, search_type, caseless, comp_pattern, show_error)
     char *pattern;
     int search_type;
+    int caseless;
     PATTERN_TYPE *comp_pattern;
     int show_error;
 {
@@ -50,7 +51,7 @@ compile_pattern2(pattern, search_type, comp_pattern, show_error)
 #endif
 #if HAVE_POSIX_REGCOMP
     regex_t *comp = (regex_t *) ecalloc(1, sizeof(regex_t));
-    if (regcomp(comp, pattern, REGCOMP_FLAG | (is_caseless ? REG_ICASE : 0)))
+    if (regcomp(comp, pattern, REGCOMP_FLAG | (caseless ? REG_ICASE : 0)))
     {
         free(comp);
         if (show_error)
@@ -70,7 +71,7 @@ compile_pattern2(pattern, search_type, comp_pattern, show_error)
     PARG parg;
     pcre *comp = pcre_compile(pattern,
             ((utf_mode) ? PCRE_UTF8 | PCRE_NO_UTF8_CHECK : 0) |
-            (is_caseless ? PCRE_CASELESS : 0),
+            (caseless ? PCRE_CASELESS : 0),
             &errstring, &erroffset, NULL);
     if (comp == NULL)
     {
@@ -85,10 +86,11 @@ compile_pattern2(pattern, search_type, comp_pattern, show_error)
     int errcode;
     PCRE2_SIZE erroffset;
     PARG parg;
-    pcre2_code *comp = pcre2_compile((PCRE2_SPTR)pattern, strlen(pattern),
-            (is_caseless ? PCRE2_CASELESS : 0),
+    struct re_pcre2 *comp;
+    pcre2_code *code = pcre2_compile((PCRE2_SPTR)pattern, strlen(pattern),
+            (caseless ? PCRE2_CASELESS : 0),
             &errcode, &erroffset, NULL);
-    if (comp == NULL)
+    if (code == NULL)
     {
         if (show_error)
         {
@@ -99,6 +101,20 @@ compile_pattern2(pattern, search_type, comp_pattern, show_error)
         }
         return (-1);
     }
+    /*
+     * Use the JIT compiler where the library has one;
+     * otherwise pcre2_match interprets the pattern.
+     */
+    (void) pcre2_jit_compile(code, PCRE2_JIT_COMPLETE);
+    comp = (struct re_pcre2 *) ecalloc(1, sizeof(struct re_pcre2));
+    comp->code = code;
+    comp->md = pcre2_match_data_create(3, NULL);
+    if (comp->md == NULL)
+    {
+        error("Cannot allocate memory", NULL_PARG);
+        quit(QUIT_ERROR);
+    }
+    uncompile_pattern(comp_pattern);
     *comp_pattern = comp;
 #endif
 #if HAVE_RE_COMP
@@ -146,25 +162,28 @@ compile_pattern2(pattern, search_type, comp_pattern, show_error)
 
 /*
  * Like compile_pattern2, but convert the pattern to lowercase if necessary.
+ * A caseless pattern is matched against lines converted to lowercase
+ * when the regex library cannot ignore case itself.
  */
     public int
-compile_pattern(pattern, search_type, show_error, comp_pattern)
+compile_pattern(pattern, search_type, caseless, show_error, comp_pattern)
     char *pattern;
     int search_type;
+    int caseless;
     int show_error;
     PATTERN_TYPE *comp_pattern;
 {
     char *cvt_pattern;
     int result;
 
-    if (caseless != OPT_ONPLUS || re_handles_caseless)
+    if (!caseless || re_handles_caseless)
         cvt_pattern = pattern;
     else
     {
         cvt_pattern = (char*) ecalloc(1, cvt_length(strlen(pattern), CVT_TO_LC));
         cvt_text(cvt_pattern, pattern, (int *)NULL, (int *)NULL, CVT_TO_LC);
     }
-    result = compile_pattern2(cvt_pattern, search_type, comp_pattern, show_error);
+    result = compile_pattern2(cvt_pattern, search_type, caseless, comp_pattern, show_error);
     if (cvt_pattern != pattern)
         free(cvt_pattern);
     return (result);
@@ -200,7 +219,11 @@ uncompile_pattern(pattern)
 #endif
 #if HAVE_PCRE2
     if (*pattern != NULL)
-        pcre2_code_free(*pattern);
+    {
+        pcre2_match_data_free((*pattern)->md);
+        pcre2_code_free((*pattern)->code);
+        free(*pattern);
+    }
     *pattern = NULL;
 #endif
 #if HAVE_RE_COMP
@@ -218,6 +241,72 @@ uncompile_pattern(pattern)
 #endif
 }
 
+/*
+ * Make a copy of a compiled pattern for one of several threads
+ * which call match_pattern at once.  A PCRE2 copy shares the
+ * compiled code and has match data of its own.  A POSIX regex_t
+ * cannot be shared, since regexec may lock it (as glibc's does),
+ * so the text of the pattern is compiled again, as caseless says.
+ * Return -1 if the copy cannot be made.
+ */
+    public int
+thread_pattern(pattern, text, search_type, caseless, copy)
+    PATTERN_TYPE pattern;
+    char *text;
+    int search_type;
+    int caseless;
+    PATTERN_TYPE *copy;
+{
+#if HAVE_POSIX_REGCOMP
+    SET_NULL_PATTERN(*copy);
+    if (pattern != NULL)
+        return (compile_pattern(text, search_type, caseless, 0, copy));
+    return (0);
+#else
+#if HAVE_PCRE2
+    struct re_pcre2 *comp;
+
+    if (pattern != NULL)
+    {
+        comp = (struct re_pcre2 *) malloc(sizeof(struct re_pcre2));
+        if (comp == NULL)
+            return (-1);
+        comp->code = pattern->code;
+        comp->md = pcre2_match_data_create(3, NULL);
+        if (comp->md == NULL)
+        {
+            free(comp);
+            return (-1);
+        }
+        *copy = comp;
+        return (0);
+    }
+#endif
+    *copy = pattern;
+    return (0);
+#endif
+}
+
+/*
+ * Forget a copy made by thread_pattern.
+ */
+    public void
+free_thread_pattern(copy)
+    PATTERN_TYPE *copy;
+{
+#if HAVE_POSIX_REGCOMP
+    uncompile_pattern(copy);
+#endif
+#if HAVE_PCRE2
+    if (*copy != NULL)
+    {
+        pcre2_match_data_free((*copy)->md);
+        free(*copy);
+    }
+#endif
+    SET_NULL_PATTERN(*copy);
+}
+
 #if 0
 /*
  * Can a pattern be successfully compiled?
@@ -230,7 +319,7 @@ valid_pattern(pattern)
     int result;
 
     SET_NULL_PATTERN(comp_pattern);
-    result = compile_pattern2(pattern, 0, &comp_pattern, 0);
+    result = compile_pattern2(pattern, 0, 0, &comp_pattern, 0);
     if (result != 0)
         return (0);
     uncompile_pattern(&comp_pattern);
@@ -272,44 +361,501 @@ is_null_pattern(pattern)
 }
 
 /*
- * Simple pattern matching function.
- * It supports no metacharacters like *, etc.
+ * Characters which are special in a regular expression.
+ */
+static char re_metachars[] = "\\^$.[]|()*+?{}";
+
+#if !HAVE_RE_COMP && !HAVE_REGCMP
+/*
+ * Letters which, after a backslash, stand for a single character
+ * class or assertion and take no argument.
+ */
+static char re_simple_escapes[] = "bBdDsSwW";
+
+/*
+ * Return the character after a bracket expression.
+ * p points just past the opening bracket.
+ */
+    static char *
+skip_bracket(p)
+    char *p;
+{
+    char d;
+
+    if (*p == '^')
+        p++;
+    if (*p == ']')
+        p++;
+    while (*p != '\0' && *p != ']')
+    {
+        if (*p == '[' && (p[1] == ':' || p[1] == '.' || p[1] == '='))
+        {
+            /* Character class, collating symbol or equivalence class. */
+            d = p[1];
+            for (p += 2;  *p != '\0' && !(p[0] == d && p[1] == ']');  p++)
+                continue;
+            if (*p != '\0')
+                p += 2;
+        } else if (*p == '\\' && p[1] != '\0')
+            p += 2;
+        else
+            p++;
+    }
+    if (*p == ']')
+        p++;
+    return (p);
+}
+
+/*
+ * Find the longest string which every match of a regular expression
+ * must contain: a run of ordinary ASCII characters outside any group
+ * or bracket expression, none of which a repetition makes optional.
+ * Copy it to buf, which is as long as the pattern, and return its length.
+ * Return 0 if the expression has alternatives at the top level or
+ * uses syntax not understood here.
  */
     static int
-match(pattern, pattern_len, buf, buf_len, pfound, pend)
+required_factor(pattern, buf)
     char *pattern;
-    int pattern_len;
     char *buf;
-    int buf_len;
-    char **pfound, **pend;
 {
-    char *pp, *lp;
-    char *pattern_end = pattern + pattern_len;
-    char *buf_end = buf + buf_len;
+    char *run;
+    char *p;
+    char c;
+    int nrun = 0;
+    int nbest = 0;
+    int depth = 0;
+    int ordinary;
 
-    for ( ;  buf < buf_end;  buf++)
+    run = (char *) ecalloc(1, strlen(pattern) + 1);
+    for (p = pattern;  *p != '\0';  )
     {
-        for (pp = pattern, lp = buf;  ;  pp++, lp++)
+        c = *p++;
+        ordinary = FALSE;
+        switch (c)
+        {
+        case '\\':
+            if (*p != '\0' && strchr(re_metachars, *p) != NULL)
+            {
+                c = *p++;
+                ordinary = TRUE;
+            } else if (*p != '\0' && strchr(re_simple_escapes, *p) != NULL)
+                p++;
+            else
+            {
+                /*
+                 * An escape which may take an argument (\x41, \1, \k<n>):
+                 * ignore everything up to the next metacharacter.
+                 */
+                while (*p != '\0' && strchr(re_metachars, *p) == NULL)
+                    p++;
+            }
+            break;
+        case '[':
+            p = skip_bracket(p);
+            break;
+        case '(':
+            if (*p == '?')
+            {
+                /* Option settings and assertions. */
+                nbest = 0;
+                goto done;
+            }
+            depth++;
+            break;
+        case ')':
+            if (depth > 0)
+                depth--;
+            break;
+        case '|':
+            if (depth == 0)
+            {
+                nbest = 0;
+                goto done;
+            }
+            break;
+        case '*':
+        case '?':
+        case '{':
+            /* The repeated character may be absent. */
+            if (nrun > 0)
+                nrun--;
+            if (c == '{')
+                while (*p != '\0' && *p++ != '}')
+                    continue;
+            break;
+        case '+':
+        case '^':
+        case '$':
+        case '.':
+            break;
+        default:
+            ordinary = IS_ASCII_OCTET(c);
+            break;
+        }
+        if (ordinary && depth == 0)
         {
-            char cp = *pp;
-            char cl = *lp;
-            if (caseless == OPT_ONPLUS && ASCII_IS_UPPER(cp))
-                cp = ASCII_TO_LOWER(cp);
-            if (cp != cl)
-                break;
-            if (pp == pattern_end || lp == buf_end)
-                break;
+            run[nrun++] = c;
+            continue;
         }
-        if (pp == pattern_end)
+        if (nrun > nbest)
         {
-            if (pfound != NULL)
-                *pfound = buf;
-            if (pend != NULL)
-                *pend = lp;
-            return (1);
+            memcpy(buf, run, nrun);
+            nbest = nrun;
         }
+        nrun = 0;
     }
-    return (0);
+    if (nrun > nbest)
+    {
+        memcpy(buf, run, nrun);
+        nbest = nrun;
+    }
+done:
+    free(run);
+    return (nbest);
+}
+#endif
+
+/*
+ * Make a literal pattern from a string.
+ * If caseless is set, it ignores the case of ASCII letters.
+ */
+    static struct literal *
+new_literal(text, len, whole, caseless)
+    char *text;
+    int len;
+    int whole;
+    int caseless;
+{
+    struct literal *lit;
+    int i;
+
+    lit = (struct literal *) ecalloc(1, sizeof(struct literal));
+    lit->len = len;
+    lit->text = (char *) ecalloc(1, len + 1);
+    lit->caseless = caseless;
+    lit->whole = whole;
+    for (i = 0;  i < len;  i++)
+    {
+        char c = text[i];
+        if (lit->caseless && ASCII_IS_UPPER(c))
+            c = ASCII_TO_LOWER(c);
+        lit->text[i] = c;
+    }
+    /*
+     * Horspool skip table: how far the window can move
+     * when a given byte is under its last position.
+     */
+    for (i = 0;  i < 256;  i++)
+        lit->skip[i] = len;
+    for (i = 0;  i < len - 1;  i++)
+    {
+        unsigned char c = (unsigned char) lit->text[i];
+        lit->skip[c] = len - 1 - i;
+        if (lit->caseless && ASCII_IS_LOWER(c))
+            lit->skip[ASCII_TO_UPPER(c)] = len - 1 - i;
+    }
+    return (lit);
+}
+
+/*
+ * Compile a pattern which can be matched as a literal string,
+ * for use by match_pattern.
+ * If the pattern is a regular expression with metacharacters, the
+ * result is instead a string which every match contains (whole is FALSE),
+ * so that lines without it need not be given to the regex library.
+ * If caseless is set, the literal ignores the case of ASCII letters.
+ * Return NULL if there is no such string.
+ */
+    public struct literal *
+compile_literal(pattern, search_type, caseless)
+    char *pattern;
+    int search_type;
+    int caseless;
+{
+    char *p;
+
+#if NO_REGEX
+    search_type |= SRCH_NO_REGEX;
+#endif
+    if (pattern == NULL)
+        return (NULL);
+    if (search_type & SRCH_NO_REGEX)
+        return (new_literal(pattern, (int) strlen(pattern), TRUE, caseless));
+    /*
+     * A regular expression without metacharacters
+     * matches just the string itself.
+     * Regex libraries fold non-ASCII letters too, so
+     * only take over caseless patterns which are ASCII.
+     */
+    for (p = pattern;  *p != '\0';  p++)
+        if (strchr(re_metachars, *p) != NULL ||
+            (caseless && !IS_ASCII_OCTET(*p)))
+            break;
+    if (*p == '\0')
+        return (new_literal(pattern, (int) strlen(pattern), TRUE, caseless));
+#if HAVE_RE_COMP || HAVE_REGCMP
+    /* Basic regular expressions use \( and \{ for groups and repetitions. */
+    return (NULL);
+#else
+  {
+    /*
+     * Otherwise, look for a string every match must contain.
+     * A single character is not worth checking separately.
+     */
+    struct literal *lit;
+    char *buf = (char *) ecalloc(1, strlen(pattern) + 1);
+    int len = required_factor(pattern, buf);
+    lit = (len < 2) ? NULL : new_literal(buf, len, FALSE, caseless);
+    free(buf);
+    return (lit);
+  }
+#endif
+}
+
+/*
+ * Forget a compiled literal pattern.
+ */
+    public void
+uncompile_literal(plit)
+    struct literal **plit;
+{
+    if (*plit != NULL)
+    {
+        free((*plit)->text);
+        free(*plit);
+    }
+    *plit = NULL;
+}
+
+/*
+ * Compare a string with the first len bytes of a literal,
+ * ignoring the case of ASCII letters in the string.
+ */
+    static int
+caseless_eq(s, t, len)
+    unsigned char *s;
+    unsigned char *t;
+    int len;
+{
+    for (;  len > 0;  s++, t++, len--)
+    {
+        unsigned char c = *s;
+        if (ASCII_IS_UPPER(c))
+            c = ASCII_TO_LOWER(c);
+        if (c != *t)
+            return (0);
+    }
+    return (1);
+}
+
+/*
+ * Find the first occurrence of a literal in a buffer.
+ */
+    public char *
+find_literal(lit, buf, buf_len)
+    struct literal *lit;
+    char *buf;
+    size_t buf_len;
+{
+    unsigned char *p = (unsigned char *) buf;
+    unsigned char *t = (unsigned char *) lit->text;
+    unsigned char *last_start;
+    int last = lit->len - 1;
+    unsigned char c;
+
+    if (lit->len == 0)
+        return (buf);
+    if ((size_t) lit->len > buf_len)
+        return (NULL);
+    last_start = p + buf_len - lit->len;
+    if (!lit->caseless)
+    {
+        /*
+         * Let memchr find each candidate for the first byte.
+         */
+        while (p <= last_start)
+        {
+            p = (unsigned char *) memchr(p, t[0], (size_t) (last_start - p + 1));
+            if (p == NULL)
+                return (NULL);
+            if (p[last] == t[last] && memcmp(p, t, last) == 0)
+                return ((char *) p);
+            p++;
+        }
+        return (NULL);
+    }
+    while (p <= last_start)
+    {
+        c = p[last];
+        if (ASCII_IS_UPPER(c))
+            c = ASCII_TO_LOWER(c);
+        if (c == t[last] && caseless_eq(p, t, last))
+            return ((char *) p);
+        p += lit->skip[p[last]];
+    }
+    return (NULL);
+}
+
+/*
+ * Build an automaton which finds any of a number of literals.
+ */
+    public struct litset *
+compile_litset(lits, nlits)
+    struct literal **lits;
+    int nlits;
+{
+    struct litset *set;
+    int *fail;
+    int *queue;
+    int qhead, qtail;
+    int maxstates;
+    int i, j, c, s, t;
+
+    if (nlits > LITSET_MAX)
+        return (NULL);
+    set = (struct litset *) ecalloc(1, sizeof(struct litset));
+    set->nlits = nlits;
+    maxstates = 1;
+    for (i = 0;  i < nlits;  i++)
+    {
+        set->lits[i] = lits[i];
+        maxstates += lits[i]->len;
+        if (lits[i]->caseless)
+            set->caseless = TRUE;
+    }
+    set->next = (int *) ecalloc(maxstates * 256, sizeof(int));
+    set->out = (unsigned long *) ecalloc(maxstates, sizeof(unsigned long));
+    fail = (int *) ecalloc(maxstates, sizeof(int));
+    queue = (int *) ecalloc(maxstates, sizeof(int));
+
+    /*
+     * Make a trie of the strings; state 0 is the root.
+     * -1 marks a missing edge while the trie is built.
+     */
+    for (i = 0;  i < maxstates * 256;  i++)
+        set->next[i] = -1;
+    set->nstates = 1;
+    for (i = 0;  i < nlits;  i++)
+    {
+        s = 0;
+        for (j = 0;  j < lits[i]->len;  j++)
+        {
+            c = (unsigned char) lits[i]->text[j];
+            if (set->caseless && ASCII_IS_UPPER(c))
+                c = ASCII_TO_LOWER(c);
+            if (set->next[s*256 + c] < 0)
+                set->next[s*256 + c] = set->nstates++;
+            s = set->next[s*256 + c];
+        }
+        set->out[s] |= 1UL << i;
+    }
+
+    /*
+     * Fill in the missing edges breadth first, each from the
+     * state reached by the longest proper suffix which is also
+     * a prefix of some string (the failure state).
+     */
+    qhead = qtail = 0;
+    for (c = 0;  c < 256;  c++)
+    {
+        t = set->next[c];
+        if (t < 0)
+            set->next[c] = 0;
+        else
+        {
+            fail[t] = 0;
+            queue[qtail++] = t;
+        }
+    }
+    while (qhead < qtail)
+    {
+        s = queue[qhead++];
+        set->out[s] |= set->out[fail[s]];
+        for (c = 0;  c < 256;  c++)
+        {
+            t = set->next[s*256 + c];
+            if (t < 0)
+                set->next[s*256 + c] = set->next[fail[s]*256 + c];
+            else
+            {
+                fail[t] = set->next[fail[s]*256 + c];
+                queue[qtail++] = t;
+            }
+        }
+    }
+    if (set->caseless)
+    {
+        /* Uppercase bytes go where their lowercase letters go. */
+        for (s = 0;  s < set->nstates;  s++)
+            for (c = 'A';  c <= 'Z';  c++)
+                set->next[s*256 + c] = set->next[s*256 + ASCII_TO_LOWER(c)];
+    }
+    free(fail);
+    free(queue);
+    return (set);
+}
+
+/*
+ * Forget an automaton made by compile_litset.
+ * The literals themselves belong to the caller.
+ */
+    public void
+uncompile_litset(pset)
+    struct litset **pset;
+{
+    if (*pset != NULL)
+    {
+        free((*pset)->next);
+        free((*pset)->out);
+        free(*pset);
+    }
+    *pset = NULL;
+}
+
+/*
+ * Find which literals of a set occur in a buffer.
+ * Return a mask with bit i set if literal i occurs.
+ */
+    public unsigned long
+scan_litset(set, buf, buf_len)
+    struct litset *set;
+    char *buf;
+    size_t buf_len;
+{
+    unsigned char *p = (unsigned char *) buf;
+    unsigned char *ep = p + buf_len;
+    unsigned long all = (set->nlits == LITSET_MAX) ? ~0UL : (1UL << set->nlits) - 1;
+    unsigned long found = 0;
+    unsigned long out;
+    int s = 0;
+    int i;
+
+    for (;  p < ep;  p++)
+    {
+        s = set->next[s*256 + *p];
+        out = set->out[s] & ~found;
+        if (out == 0)
+            continue;
+        for (i = 0;  i < set->nlits;  i++)
+        {
+            struct literal *lit;
+            if (!(out & (1UL << i)))
+                continue;
+            /*
+             * A caseless automaton also stops at case-sensitive
+             * literals in the wrong case; check those exactly.
+             */
+            lit = set->lits[i];
+            if (set->caseless && !lit->caseless &&
+                memcmp(p + 1 - lit->len, lit->text, lit->len) != 0)
+                continue;
+            found |= 1UL << i;
+        }
+        if (found == all)
+            break;
+    }
+    return (found);
 }
 
 /*
@@ -317,9 +863,9 @@ match(pattern, pattern_len, buf, buf_len, pfound, pend)
  * Set sp and ep to the start and end of the matched string.
  */
     public int
-match_pattern(pattern, tpattern, line, line_len, sp, ep, notbol, search_type)
+match_pattern(pattern, lit, line, line_len, sp, ep, notbol, search_type)
     PATTERN_TYPE pattern;
-    char *tpattern;
+    struct literal *lit;
     char *line;
     size_t line_len;
     char **sp;
@@ -333,9 +879,19 @@ match_pattern(pattern, tpattern, line, line_len, sp, ep, notbol, search_type)
 #if NO_REGEX
     search_type |= SRCH_NO_REGEX;
 #endif
-    if (search_type & SRCH_NO_REGEX)
-        matched = match(tpattern, strlen(tpattern), line, line_len, sp, ep);
-    else
+    if (lit != NULL && lit->whole)
+    {
+        *sp = find_literal(lit, line, line_len);
+        matched = (*sp != NULL);
+        if (matched)
+            *ep = *sp + lit->len;
+    } else if (search_type & SRCH_NO_REGEX)
+        matched = 0;
+    else if (lit != NULL && find_literal(lit, line, line_len) == NULL)
+    {
+        /* The line lacks a string which every match contains. */
+        matched = 0;
+    } else
     {
 #if HAVE_GNU_REGEX
     {
@@ -388,16 +944,21 @@ match_pattern(pattern, tpattern, line, line_len, sp, ep, notbol, search_type)
 #if HAVE_PCRE2
     {
         int flags = (notbol) ? PCRE2_NOTBOL : 0;
-        pcre2_match_data *md = pcre2_match_data_create(3, NULL);
-        matched = pcre2_match(pattern, (PCRE2_SPTR)line, line_len,
-            0, flags, md, NULL) >= 0;
+        int rc = pcre2_match(pattern->code, (PCRE2_SPTR)line, line_len,
+            0, flags, pattern->md, NULL);
+        if (rc == PCRE2_ERROR_JIT_STACKLIMIT)
+        {
+            /* Too deep for the JIT stack; the interpreter can do it. */
+            rc = pcre2_match(pattern->code, (PCRE2_SPTR)line, line_len,
+                0, flags | PCRE2_NO_JIT, pattern->md, NULL);
+        }
+        matched = (rc >= 0);
         if (matched)
         {
-            PCRE2_SIZE *ovector = pcre2_get_ovector_pointer(md);
+            PCRE2_SIZE *ovector = pcre2_get_ovector_pointer(pattern->md);
             *sp = line + ovector[0];
             *ep = line + ovector[1];
         }
-        pcre2_match_data_free(md);
     }
 #endif
 #if HAVE_RE_COMP
@@ -12,6 +12,7 @@
 #include <regex.h>
 #define PATTERN_TYPE             struct re_pattern_buffer *
 #define SET_NULL_PATTERN(name)   name = NULL
+#define re_uses_length           TRUE
 #endif
 
 /* ---- POSIX ---- */
@@ -25,6 +26,10 @@
 #define PATTERN_TYPE             regex_t *
 #define SET_NULL_PATTERN(name)   name = NULL
 #define re_handles_caseless      TRUE
+#define re_reentrant             TRUE
+#ifdef REG_STARTEND
+#define re_uses_length           TRUE
+#endif
 #endif
 
 /* ---- PCRE ---- */
@@ -33,15 +38,28 @@
 #define PATTERN_TYPE             pcre *
 #define SET_NULL_PATTERN(name)   name = NULL
 #define re_handles_caseless      TRUE
+#define re_reentrant             TRUE
+#define re_uses_length           TRUE
 #endif
 
 /* ---- PCRE2 ---- */
 #if HAVE_PCRE2
 #define PCRE2_CODE_UNIT_WIDTH 8
 #include <pcre2.h>
-#define PATTERN_TYPE             pcre2_code *
+/*
+ * A compiled pattern, with a match data block which match_pattern
+ * reuses rather than allocating one for each line.
+ */
+struct re_pcre2
+{
+    pcre2_code *code;
+    pcre2_match_data *md;
+};
+#define PATTERN_TYPE             struct re_pcre2 *
 #define SET_NULL_PATTERN(name)   name = NULL
 #define re_handles_caseless      TRUE
+#define re_reentrant             TRUE
+#define re_uses_length           TRUE
 #endif
 
 /* ---- RE_COMP  ---- */
@@ -73,8 +91,51 @@ extern int reg_show_error;
 #if NO_REGEX
 #define PATTERN_TYPE             void *
 #define SET_NULL_PATTERN(name)
+#define re_reentrant             TRUE
+#define re_uses_length           TRUE
 #endif
 
 #ifndef re_handles_caseless
 #define re_handles_caseless      FALSE
 #endif
+
+/*
+ * Can match_pattern be called from several threads at once,
+ * each with its own copy of the pattern made by thread_pattern?
+ */
+#ifndef re_reentrant
+#define re_reentrant             FALSE
+#endif
+
+/* Does match_pattern go by the length of a line, not a null at its end? */
+#ifndef re_uses_length
+#define re_uses_length           FALSE
+#endif
+
+/*
+ * A string to be found literally, with its skip table.
+ */
+struct literal
+{
+    char *text;                     /* The string */
+    int len;                        /* Length of the string */
+    int caseless;                   /* Ignore case of ASCII letters */
+    int whole;                      /* The string is the whole pattern */
+    int skip[256];                  /* Shift by last byte of window */
+};
+
+/*
+ * A set of literal strings, all found in one pass over a line
+ * by an Aho-Corasick automaton.
+ */
+#define LITSET_MAX      32          /* Most strings in a set */
+
+struct litset
+{
+    int nlits;
+    struct literal *lits[LITSET_MAX];
+    int caseless;                   /* Automaton reads bytes as lowercase */
+    int nstates;
+    int *next;                      /* Next state, by state and byte */
+    unsigned long *out;             /* Strings which end in each state */
+};
@@ -45,9 +45,9 @@ static constant char s_proto[] =
 static constant char m_proto[] =
   "?n?f%f .?m(%T %i of %m) ..?e(END) ?x- Next\\: %x.:?pB%pB\\%:byte %bB?s/%s...%t";
 static constant char M_proto[] =
-  "?f%f .?n?m(%T %i of %m) ..?ltlines %lt-%lb?L/%L. :byte %bB?s/%s. .?e(END) ?x- Next\\: %x.:?pB%pB\\%..%t";
+  "?f%f .?n?m(%T %i of %m) ..?ltlines %lt-%lb?L/%L. :byte %bB?s/%s. .?K(%K) .?e(END) ?x- Next\\: %x.:?pB%pB\\%..%t";
 static constant char e_proto[] =
-  "?f%f .?m(%T %i of %m) .?ltlines %lt-%lb?L/%L. .byte %bB?s/%s. ?e(END) :?pB%pB\\%..%t";
+  "?f%f .?m(%T %i of %m) .?ltlines %lt-%lb?L/%L. .byte %bB?s/%s. ?H(%H) .?K(%K) .?e(END) :?pB%pB\\%..%t";
 static constant char h_proto[] =
   "HELP -- ?eEND -- Press g to see it again:Press RETURN for more., or q when done";
 static constant char w_proto[] =
@@ -173,6 +173,19 @@ curr_byte(where)
     return (pos);
 }
 
+/*
+ * Is the last line number still being counted between commands?
+ * It is then taken to be unknown, rather than counted at once.
+ */
+    static int
+final_pending(VOID_PARAM)
+{
+    POSITION bytes;
+    LINENUM lines;
+
+    return (scan_ahead_progress(&bytes, &lines));
+}
+
 /*
  * Return the value of a prototype conditional.
  * A prototype string may include conditionals which consist of a
@@ -206,7 +219,7 @@ cond(c, where)
         return (currline(where) != 0);
     case 'L': /* Final line number known? */
     case 'D': /* Final page number known? */
-        return (linenums && ch_length() != NULL_POSITION);
+        return (linenums && ch_length() != NULL_POSITION && !final_pending());
     case 'm': /* More than one file? */
 #if TAGS
         return (ntags() ? (ntags() > 1) : (nifile() > 1));
@@ -223,12 +236,28 @@ cond(c, where)
         return (curr_byte(where) != NULL_POSITION &&
                 ch_length() > 0);
     case 'P': /* Percent into file (lines) known? */
-        return (currline(where) != 0 &&
+        return (currline(where) != 0 && !final_pending() &&
                 (len = ch_length()) > 0 &&
                 find_linenum(len) != 0);
     case 's': /* Size of file known? */
     case 'B':
         return (ch_length() != NULL_POSITION);
+    case 'S': /* Lines being counted? */
+        return (final_pending());
+#if HILITE_SEARCH
+    case 'H': /* Lines shown by the filters known? */
+        {
+            LINENUM shown;
+            LINENUM lines;
+            return (filter_counts(&shown, &lines));
+        }
+#endif
+    case 'K': /* Matching lines counted? */
+        {
+            int k;
+            int n;
+            return (match_counts(&k, &n));
+        }
     case 'x': /* Is there a "next" file? */
 #if TAGS
         if (ntags())
@@ -285,7 +314,7 @@ protochar(c, where, iseditproto)
     case 'D': /* Final page number */
         /* Find the page number of the last byte in the file (len-1). */
         len = ch_length();
-        if (len == NULL_POSITION)
+        if (len == NULL_POSITION || final_pending())
             ap_quest();
         else if (len == 0)
             /* An empty file has no pages. */
@@ -332,7 +361,7 @@ protochar(c, where, iseditproto)
         break;
     case 'L': /* Final line number */
         len = ch_length();
-        if (len == NULL_POSITION || len == ch_zero() ||
+        if (len == NULL_POSITION || len == ch_zero() || final_pending() ||
             (linenum = find_linenum(len)) <= 0)
             ap_quest();
         else
@@ -357,7 +386,7 @@ protochar(c, where, iseditproto)
         break;
     case 'P': /* Percent into file (lines) */
         linenum = currline(where);
-        if (linenum == 0 ||
+        if (linenum == 0 || final_pending() ||
             (len = ch_length()) == NULL_POSITION || len == ch_zero() ||
             (last_linenum = find_linenum(len)) <= 0)
             ap_quest();
@@ -372,6 +401,57 @@ protochar(c, where, iseditproto)
         else
             ap_quest();
         break;
+    case 'S': /* Lines counted so far */
+        if (scan_ahead_progress(&pos, &linenum))
+        {
+            ap_linenum(linenum);
+            ap_str(" lines, ");
+            ap_pos(pos);
+            ap_str(" bytes");
+        } else
+            ap_quest();
+        break;
+#if HILITE_SEARCH
+    case 'H': /* Lines shown by the filters */
+        {
+            LINENUM shown;
+            if (filter_counts(&shown, &linenum))
+            {
+                ap_linenum(shown);
+                ap_str(" of ");
+                ap_linenum(linenum);
+                ap_str(" lines shown");
+            } else
+                ap_quest();
+        }
+        break;
+#endif
+    case 'K': /* Matching lines counted */
+        {
+            int k;
+            int n;
+            int r = match_counts(&k, &n);
+            if (r != 0)
+            {
+                ap_str("line ");
+                ap_int(k);
+                ap_str((r == 2) ? " of at least " : " of ");
+                ap_int(n);
+            } else
+                ap_quest();
+        }
+        break;
+    case 'O': /* Output used to update the screen */
+        {
+            POSITION bytes;
+            int writes;
+            output_counts(&bytes, &writes);
+            ap_pos(bytes);
+            ap_str(" bytes in ");
+            ap_int(writes);
+            ap_str((writes == 1) ? " write" : " writes");
+        }
+        break;
     case 't': /* Truncate trailing spaces in the message */
         while (mp > message && mp[-1] == ' ')
             mp--;
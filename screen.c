@@ -1732,6 +1732,7 @@ deinit_mouse(VOID_PARAM)
 init(VOID_PARAM)
 {
     clear_bot_if_needed();
+    scr_forget();
 #if !MSDOS_COMPILER
     if (!(quit_if_one_screen && one_screen))
     {
@@ -1789,6 +1790,7 @@ deinit(VOID_PARAM)
 {
     if (!init_done)
         return;
+    scr_forget();
 #if !MSDOS_COMPILER
     if (!(quit_if_one_screen && one_screen))
     {
@@ -1842,6 +1844,8 @@ assert_interactive(VOID_PARAM)
 home(VOID_PARAM)
 {
     assert_interactive();
+    if (scr_move(0))
+        return;
 #if !MSDOS_COMPILER
     ltputs(sc_home, 1, putchr);
 #else
@@ -1858,6 +1862,8 @@ home(VOID_PARAM)
 add_line(VOID_PARAM)
 {
     assert_interactive();
+    if (scr_add_line())
+        return;
 #if !MSDOS_COMPILER
     ltputs(sc_addline, sc_height, putchr);
 #else
@@ -2068,6 +2074,7 @@ win32_scroll_up(n)
 lower_left(VOID_PARAM)
 {
     assert_interactive();
+    (void) scr_move(sc_height-1);
 #if !MSDOS_COMPILER
     ltputs(sc_lower_left, 1, putchr);
 #else
@@ -2149,6 +2156,8 @@ goto_line(sindex)
     int sindex;
 {
     assert_interactive();
+    if (scr_move(sindex))
+        return;
 #if !MSDOS_COMPILER
     ltputs(tgoto(sc_move, 0, sindex), 1, putchr);
 #else
@@ -2157,6 +2166,65 @@ goto_line(sindex)
 #endif
 }
 
+/*
+ * Goto a specific column of a specific line on the screen.
+ * Unlike goto_line, this is not noted by the screen diff code,
+ * which is what uses it.
+ */
+    public void
+goto_col(sindex, col)
+    int sindex;
+    int col;
+{
+#if !MSDOS_COMPILER
+    ltputs(tgoto(sc_move, col, sindex), 1, putchr);
+#else
+    flush();
+    _settextposition(sindex+1, col+1);
+#endif
+}
+
+/*
+ * The number of chars sent to move the cursor with goto_col.
+ */
+    public int
+goto_col_cost(sindex, col)
+    int sindex;
+    int col;
+{
+#if !MSDOS_COMPILER
+    return (cost(tgoto(sc_move, col, sindex)));
+#else
+    return (0);
+#endif
+}
+
+/*
+ * The number of chars sent to clear the screen.
+ */
+    public int
+clear_cost(VOID_PARAM)
+{
+#if !MSDOS_COMPILER
+    return (cost(sc_clear));
+#else
+    return (0);
+#endif
+}
+
+/*
+ * The number of chars sent to clear to the end of a line.
+ */
+    public int
+clear_eol_cost(VOID_PARAM)
+{
+#if !MSDOS_COMPILER
+    return (cost(sc_eol_clear));
+#else
+    return (0);
+#endif
+}
+
 #if MSDOS_COMPILER==MSOFTC || MSDOS_COMPILER==BORLANDC
 /*
  * Create an alternate screen which is all white.
@@ -2310,6 +2378,7 @@ bell(VOID_PARAM)
 clear(VOID_PARAM)
 {
     assert_interactive();
+    scr_clear();
 #if !MSDOS_COMPILER
     ltputs(sc_clear, sc_height, putchr);
 #else
@@ -2330,6 +2399,8 @@ clear(VOID_PARAM)
 clear_eol(VOID_PARAM)
 {
     /* assert_interactive();*/
+    if (scr_clear_eol())
+        return;
 #if !MSDOS_COMPILER
     ltputs(sc_eol_clear, 1, putchr);
 #else
@@ -2567,6 +2638,30 @@ tput_fmt(fmt, color, f_putc)
     attrcolor = color;
 }
 
+/*
+ * Like tput_fmt, but set both the foreground and background colors
+ * with one escape sequence.
+ */
+    static void
+tput_fmt2(fmt, fg_color, bg_color, f_putc)
+    char *fmt;
+    int fg_color;
+    int bg_color;
+    int (*f_putc)(int);
+{
+    char buf[2*INT_STRLEN_BOUND(int)+16];
+    /*
+     * Colors are less than 256, so with the high bit set
+     * this cannot be any single color, even if fg_color is 0.
+     */
+    int color = ((fg_color + 1) << 16) | (bg_color + 1) | 0x40000000;
+    if (color == attrcolor)
+        return;
+    SNPRINTF2(buf, sizeof(buf), fmt, fg_color, bg_color);
+    ltputs(buf, 1, f_putc);
+    attrcolor = color;
+}
+
     static void
 tput_color(str, f_putc)
     char *str;
@@ -2584,15 +2679,19 @@ tput_color(str, f_putc)
     switch (parse_color(str, &fg, &bg))
     {
     case CT_4BIT:
-        if (fg >= 0)
+        if (fg >= 0 && bg >= 0)
+            tput_fmt2(ESCS"[%d;%dm", sgr_color(fg), sgr_color(bg)+10, f_putc);
+        else if (fg >= 0)
             tput_fmt(ESCS"[%dm", sgr_color(fg), f_putc);
-        if (bg >= 0)
+        else if (bg >= 0)
             tput_fmt(ESCS"[%dm", sgr_color(bg)+10, f_putc);
         break;
     case CT_6BIT:
-        if (fg >= 0)
+        if (fg >= 0 && bg >= 0)
+            tput_fmt2(ESCS"[38;5;%d;48;5;%dm", fg, bg, f_putc);
+        else if (fg >= 0)
             tput_fmt(ESCS"[38;5;%dm", fg, f_putc);
-        if (bg >= 0)
+        else if (bg >= 0)
             tput_fmt(ESCS"[48;5;%dm", bg, f_putc);
         break;
     default:
@@ -16,6 +16,14 @@
 #include "position.h"
 #include "charset.h"
 
+#if HAVE_PTHREAD && HAVE_PTHREAD_H && HAVE_MMAP
+#define PSEARCH 1
+#include <pthread.h>
+#include <signal.h>
+#endif
+
+#define LIT_SPAN        (4*1024*1024)   /* Most bytes searched by skip_to_literal */
+
 #define MINPOS(a,b)     (((a) < (b)) ? (a) : (b))
 #define MAXPOS(a,b)     (((a) > (b)) ? (a) : (b))
 
@@ -36,11 +44,14 @@ extern int screen_trashed;
 extern int sc_width;
 extern int sc_height;
 extern int hshift;
+extern int search_threads;
 #if HILITE_SEARCH
 extern int hilite_search;
 extern int size_linebuf;
 extern int squished;
 extern int can_goto_line;
+extern int ignore_eoi;
+extern int def_search_type;
 static int hide_hilite;
 static POSITION prep_startpos;
 static POSITION prep_endpos;
@@ -61,6 +72,9 @@ extern POSITION xxpos;
  * tree operations are clear and node insertion, not node removal, we don't
  * need to maintain a usage bitmap or freelist and can just return nodes
  * from the pool in-order until capacity is reached.
+ * Clearing a tree keeps its pools, to be reused by the next nodes;
+ * only the first pool is marked empty, and each later pool is marked
+ * empty as allocation reaches it.
  */
 struct hilite
 {
@@ -98,6 +112,24 @@ static struct hilite_tree hilite_anchor = HILITE_INITIALIZER();
 static struct hilite_tree filter_anchor = HILITE_INITIALIZER();
 static struct pattern_info *filter_infos = NULL;
 
+/*
+ * The filter index holds the ranges of lines hidden by the filters,
+ * found by reading the file from the start while waiting for a command.
+ * Unlike the filter tree, which covers only the region around the
+ * screen and is rebuilt whenever the screen moves away from it,
+ * the index is kept until the filters or the file change.
+ * Positions before fx_pos are looked up in the index.
+ */
+#define FX_SLICE        (256*1024)      /* Bytes indexed per filter_index_step */
+
+static struct hilite *fx_ranges = NULL; /* Hidden ranges, in order */
+static int fx_nranges = 0;
+static int fx_maxranges = 0;
+static POSITION fx_pos = 0;             /* Lines are indexed up to here */
+static LINENUM fx_lines = 0;            /* Number of lines before fx_pos */
+static LINENUM fx_shown = 0;            /* Number of them not hidden */
+static int fx_cvt_ops;                  /* Conversions used to match them */
+
 #endif
 
 /*
@@ -107,7 +139,9 @@ static struct pattern_info *filter_infos = NULL;
 struct pattern_info {
     PATTERN_TYPE compiled;
     char* text;
+    struct literal *literal;
     int search_type;
+    int caseless;           /* Pattern ignores case */
     struct pattern_info *next;
 };
 
@@ -119,6 +153,48 @@ struct pattern_info {
 
 static struct pattern_info search_info;
 static int is_ucase_pattern;
+
+#if HILITE_SEARCH
+/*
+ * Highlight patterns (ESC-h) are highlighted all the time, each in its
+ * own color, independently of the search pattern.  Their matches are
+ * found while preparing the search hilites, and kept in a hilite tree
+ * for each pattern.  The literal strings of all the patterns are looked
+ * for together in one pass over a line, so that a pattern is only
+ * matched against the lines which contain its string.
+ */
+static struct pattern_info hl_infos[NUM_HIGHLIGHTS];
+static struct hilite_tree hl_anchors[NUM_HIGHLIGHTS];
+static int hl_litbit[NUM_HIGHLIGHTS];   /* Index of each string in hl_litset */
+static struct litset *hl_litset = NULL;
+static int hl_count = 0;                /* Number of patterns in use */
+#endif
+
+/* Bytes which skip_to_literal found not to contain the literal string. */
+static POSITION lit_absent_start = NULL_POSITION;
+static POSITION lit_absent_end = NULL_POSITION;
+
+/*
+ * A list of file positions, kept in order.
+ */
+struct poslist
+{
+    POSITION *pos;
+    int npos;
+    int maxpos;
+};
+
+/*
+ * The match index holds the start of every line in the current file
+ * which matches the search pattern.  It is built by a counting search
+ * (one which begins with ^T), and is then used by that search and by
+ * repeated searches, instead of reading the file again, until the
+ * pattern, the filters or the file change.
+ */
+static struct poslist mx_list = { NULL, 0, 0 };
+static POSITION mx_pos = NULL_POSITION; /* Lines are indexed up to here */
+static int mx_cvt_ops;                  /* Conversions used to match them */
+static int mx_no_match;                 /* Index holds non-matching lines */
 public int is_caseless;
 
 /*
@@ -153,10 +229,38 @@ clear_pattern(info)
 #if !NO_REGEX
     uncompile_pattern(&info->compiled);
 #endif
+    uncompile_literal(&info->literal);
+}
+
+/*
+ * Should a pattern ignore case?
+ * Ignore case if -I is set OR
+ * -i is set AND the pattern is all lowercase.
+ */
+    static int
+pattern_caseless(pattern)
+    char *pattern;
+{
+    if (pattern != NULL && is_ucase(pattern) && caseless != OPT_ONPLUS)
+        return (0);
+    return (caseless);
+}
+
+/*
+ * The conversion which a line needs before a pattern is matched
+ * against it, for the caselessness of the pattern:
+ * if the regex library cannot ignore case, the line is made lowercase.
+ */
+    static int
+caseless_cvt_ops(pcaseless)
+    int pcaseless;
+{
+    return ((pcaseless && !re_handles_caseless) ? CVT_TO_LC : 0);
 }
 
 /*
- * Compile and save a search pattern.
+ * Compile and save a pattern.
+ * Its caselessness is kept with it.
  */
     static int
 set_pattern(info, pattern, search_type, show_error)
@@ -165,16 +269,12 @@ set_pattern(info, pattern, search_type, show_error)
     int search_type;
     int show_error;
 {
-    /*
-     * Ignore case if -I is set OR
-     * -i is set AND the pattern is all lowercase.
-     */
-    is_ucase_pattern = (pattern == NULL) ? FALSE : is_ucase(pattern);
-    is_caseless = (is_ucase_pattern && caseless != OPT_ONPLUS) ? 0 : caseless;
+    int pcaseless = pattern_caseless(pattern);
+
 #if !NO_REGEX
     if (pattern == NULL)
         SET_NULL_PATTERN(info->compiled);
-    else if (compile_pattern(pattern, search_type, show_error, &info->compiled) < 0)
+    else if (compile_pattern(pattern, search_type, pcaseless, show_error, &info->compiled) < 0)
         return -1;
 #endif
     /* Pattern compiled successfully; save the text too. */
@@ -186,10 +286,29 @@ set_pattern(info, pattern, search_type, show_error)
         info->text = (char *) ecalloc(1, strlen(pattern)+1);
         strcpy(info->text, pattern);
     }
+    uncompile_literal(&info->literal);
+    info->literal = compile_literal(pattern, search_type, pcaseless);
     info->search_type = search_type;
+    info->caseless = pcaseless;
     return 0;
 }
 
+/*
+ * Compile and save a search or filter pattern,
+ * which sets the caselessness of searches.
+ */
+    static int
+set_search_pattern(info, pattern, search_type, show_error)
+    struct pattern_info *info;
+    char *pattern;
+    int search_type;
+    int show_error;
+{
+    is_ucase_pattern = (pattern == NULL) ? FALSE : is_ucase(pattern);
+    is_caseless = pattern_caseless(pattern);
+    return (set_pattern(info, pattern, search_type, show_error));
+}
+
 /*
  * Initialize saved pattern to nothing.
  */
@@ -199,7 +318,9 @@ init_pattern(info)
 {
     SET_NULL_PATTERN(info->compiled);
     info->text = NULL;
+    info->literal = NULL;
     info->search_type = 0;
+    info->caseless = 0;
     info->next = NULL;
 }
 
@@ -209,6 +330,12 @@ init_pattern(info)
     public void
 init_search(VOID_PARAM)
 {
+#if HILITE_SEARCH
+    int i;
+
+    for (i = 0;  i < NUM_HIGHLIGHTS;  i++)
+        init_pattern(&hl_infos[i]);
+#endif
     init_pattern(&search_info);
 }
 
@@ -220,8 +347,7 @@ get_cvt_ops(VOID_PARAM)
 {
     int ops = 0;
 
-    if (is_caseless && !re_handles_caseless)
-        ops |= CVT_TO_LC;
+    ops |= caseless_cvt_ops(is_caseless);
     if (bs_mode == BS_SPECIAL)
         ops |= CVT_BS;
     if (bs_mode != BS_CONTROL)
@@ -231,6 +357,75 @@ get_cvt_ops(VOID_PARAM)
     return (ops);
 }
 
+/*
+ * Read a raw line to be matched against patterns.
+ * Unless the pattern matcher needs a null at the end of the line,
+ * the line need not be copied out of the input buffer.
+ */
+#define forw_match_line(pos, linep, lenp) \
+    (re_uses_length ? forw_raw_line_nocopy(pos, linep, lenp) : forw_raw_line(pos, linep, lenp))
+
+/*
+ * Scratch space for cvt_line.  It grows to fit the longest line
+ * converted so far and is reused for every line after that.
+ */
+static char *cvt_buf = NULL;
+static int *cvt_buf_chpos = NULL;
+static size_t cvt_buf_size = 0;
+
+/*
+ * Convert a line for matching, as cvt_ops say.
+ * If that would leave it unchanged, the line itself is returned.
+ * Otherwise the result is in the scratch space, which the next
+ * call overwrites.
+ * *pchpos is set to NULL if each char is at the same offset in the
+ * raw line as in the converted one, as when only case is changed.
+ */
+    static char *
+cvt_line(line, plen, cvt_ops, pchpos)
+    char *line;
+    int *plen;
+    int cvt_ops;
+    int **pchpos;
+{
+    size_t cvt_len;
+    int len;
+
+    len = cvt_unchanged(line, *plen, cvt_ops);
+    if (len >= 0 && (re_uses_length || len == *plen))
+    {
+        *plen = len;
+        *pchpos = NULL;
+        return (line);
+    }
+    cvt_len = cvt_length(*plen, cvt_ops);
+    if (cvt_len > cvt_buf_size)
+    {
+        size_t size = (cvt_buf_size > 0) ? cvt_buf_size : 1024;
+        while (size < cvt_len)
+            size *= 2;
+        if (cvt_buf != NULL)
+        {
+            free(cvt_buf);
+            free(cvt_buf_chpos);
+        }
+        cvt_buf = (char *) ecalloc(1, size);
+        cvt_buf_chpos = (int *) ecalloc(sizeof(int), size);
+        cvt_buf_size = size;
+    }
+    if (cvt_text(cvt_buf, line, cvt_buf_chpos, plen, cvt_ops))
+        *pchpos = NULL;
+    else
+        *pchpos = cvt_buf_chpos;
+    return (cvt_buf);
+}
+
+/*
+ * The offset in the raw line of the char at offset i of a line
+ * converted by cvt_line.
+ */
+#define cvt_srcpos(chpos, i)    (((chpos) == NULL) ? (i) : (chpos)[i])
+
 /*
  * Is there a previous (remembered) search pattern?
  */
@@ -350,13 +545,14 @@ undo_search(clear)
     int clear;
 {
     clear_pattern(&search_info);
+    clr_match_index();
 #if HILITE_SEARCH
     if (clear)
     {
         clr_hilite();
     } else
     {
-        if (hilite_anchor.first == NULL)
+        if (hilite_anchor.root == NULL)
         {
             error("No previous regular expression", NULL_PARG);
             return;
@@ -375,17 +571,9 @@ undo_search(clear)
 clr_hlist(anchor)
     struct hilite_tree *anchor;
 {
-    struct hilite_storage *hls;
-    struct hilite_storage *nexthls;
-
-    for (hls = anchor->first;  hls != NULL;  hls = nexthls)
-    {
-        nexthls = hls->next;
-        free((void*)hls->nodes);
-        free((void*)hls);
-    }
-    anchor->first = NULL;
-    anchor->current = NULL;
+    if (anchor->first != NULL)
+        anchor->first->used = 0;
+    anchor->current = anchor->first;
     anchor->root = NULL;
 
     anchor->lookaside = NULL;
@@ -393,10 +581,24 @@ clr_hlist(anchor)
     prep_startpos = prep_endpos = NULL_POSITION;
 }
 
+/*
+ * Clear the hilites of the highlight patterns.
+ */
+    static void
+clr_highlights(VOID_PARAM)
+{
+    int i;
+
+    for (i = 0;  i < NUM_HIGHLIGHTS;  i++)
+        clr_hlist(&hl_anchors[i]);
+}
+
     public void
 clr_hilite(VOID_PARAM)
 {
     clr_hlist(&hilite_anchor);
+    /* They are prepared along with the search hilites. */
+    clr_highlights();
 }
 
     public void
@@ -529,14 +731,84 @@ hlist_find(anchor, pos)
  * Should any characters in a specified range be highlighted?
  */
     static int
-is_hilited_range(pos, epos)
+is_hilited_range(anchor, pos, epos)
+    struct hilite_tree *anchor;
     POSITION pos;
     POSITION epos;
 {
-    struct hilite_node *n = hlist_find(&hilite_anchor, pos);
+    struct hilite_node *n = hlist_find(anchor, pos);
     return (n != NULL && (epos == NULL_POSITION || epos > n->r.hl_startpos));
 }
 
+/*
+ * Get the attribute for the first highlight pattern
+ * which matches characters in a specified range.
+ */
+    static int
+highlight_attr(pos, epos)
+    POSITION pos;
+    POSITION epos;
+{
+    int i;
+
+    if (hl_count == 0)
+        return (0);
+    for (i = 0;  i < NUM_HIGHLIGHTS;  i++)
+        if (is_hilited_range(&hl_anchors[i], pos, epos))
+            return (AT_HILITE|AT_COLOR_HIGHLIGHT(i+1));
+    return (0);
+}
+
+/*
+ * Return the position up to which the filter index may be used.
+ * The index is no good if lines are now converted differently
+ * before they are matched.
+ */
+    static POSITION
+fx_limit(VOID_PARAM)
+{
+    if (fx_pos == 0 || fx_cvt_ops != get_cvt_ops())
+        return (0);
+    return (fx_pos);
+}
+
+/*
+ * Find the last hidden range in the filter index which starts
+ * at or before pos.  Return its index, or -1 if there is none.
+ */
+    static int
+fx_find(pos)
+    POSITION pos;
+{
+    int lo = 0;
+    int hi = fx_nranges - 1;
+    int found = -1;
+
+    while (lo <= hi)
+    {
+        int mid = (lo + hi) / 2;
+        if (fx_ranges[mid].hl_startpos <= pos)
+        {
+            found = mid;
+            lo = mid + 1;
+        } else
+            hi = mid - 1;
+    }
+    return (found);
+}
+
+/*
+ * Discard the filter index.
+ */
+    public void
+clr_filter_index(VOID_PARAM)
+{
+    fx_nranges = 0;
+    fx_pos = 0;
+    fx_lines = 0;
+    fx_shown = 0;
+}
+
 /*
  * Is a line "filtered" -- that is, should it be hidden?
  */
@@ -549,6 +821,11 @@ is_filtered(pos)
     if (ch_getflags() & CH_HELPFILE)
         return (0);
 
+    if (pos < fx_limit())
+    {
+        int i = fx_find(pos);
+        return (i >= 0 && pos < fx_ranges[i].hl_endpos);
+    }
     n = hlist_find(&filter_anchor, pos);
     return (n != NULL && pos >= n->r.hl_startpos);
 }
@@ -566,6 +843,15 @@ next_unfiltered(pos)
     if (ch_getflags() & CH_HELPFILE)
         return (pos);
 
+    if (pos < fx_limit())
+    {
+        int i = fx_find(pos);
+        if (i >= 0 && pos < fx_ranges[i].hl_endpos)
+            pos = fx_ranges[i].hl_endpos;
+        /* Hidden ranges in the index are never adjacent. */
+        if (pos < fx_pos)
+            return (pos);
+    }
     n = hlist_find(&filter_anchor, pos);
     while (n != NULL && pos >= n->r.hl_startpos)
     {
@@ -589,7 +875,7 @@ prev_unfiltered(pos)
         return (pos);
 
     n = hlist_find(&filter_anchor, pos);
-    while (n != NULL && pos >= n->r.hl_startpos)
+    while (pos >= fx_limit() && n != NULL && pos >= n->r.hl_startpos)
     {
         pos = n->r.hl_startpos;
         if (pos == 0)
@@ -597,6 +883,36 @@ prev_unfiltered(pos)
         pos--;
         n = n->prev;
     }
+    if (pos < fx_limit())
+    {
+        int i = fx_find(pos);
+        if (i >= 0 && pos < fx_ranges[i].hl_endpos)
+        {
+            pos = fx_ranges[i].hl_startpos;
+            if (pos > 0)
+                pos--;
+        }
+    }
+    return (pos);
+}
+
+/*
+ * If the lines just before pos are known by the filter index
+ * to be hidden, return the start of the first of them;
+ * otherwise just return pos.
+ */
+    public POSITION
+back_filtered(pos)
+    POSITION pos;
+{
+    int i;
+
+    if (pos == NULL_POSITION || pos <= 0 || pos > fx_limit() ||
+        (ch_getflags() & CH_HELPFILE))
+        return (pos);
+    i = fx_find(pos-1);
+    if (i >= 0 && pos-1 < fx_ranges[i].hl_endpos)
+        pos = fx_ranges[i].hl_startpos;
     return (pos);
 }
 
@@ -626,9 +942,9 @@ is_hilited_attr(pos, epos, nohide, p_matches)
          */
         return (AT_HILITE|AT_COLOR_ATTN);
 
-    match = is_hilited_range(pos, epos);
+    match = is_hilited_range(&hilite_anchor, pos, epos);
     if (!match)
-        return (0);
+        return ((p_matches == NULL) ? 0 : highlight_attr(pos, epos));
 
     if (p_matches == NULL)
         /*
@@ -647,13 +963,13 @@ is_hilited_attr(pos, epos, nohide, p_matches)
         /*
          * Not doing highlighting.
          */
-        return (0);
+        return (highlight_attr(pos, epos));
 
     if (!nohide && hide_hilite)
         /*
          * Highlighting is hidden.
          */
-        return (0);
+        return (highlight_attr(pos, epos));
 
     return (AT_HILITE|AT_COLOR_SEARCH);
 }
@@ -673,6 +989,13 @@ hlist_getstorage(anchor)
     {
         if (anchor->current->used < anchor->current->capacity)
             return anchor->current;
+        if (anchor->current->next != NULL)
+        {
+            /* Reuse a pool left over from before the tree was cleared. */
+            anchor->current = anchor->current->next;
+            anchor->current->used = 0;
+            return anchor->current;
+        }
         capacity = anchor->current->capacity * 2;
     }
 
@@ -689,6 +1012,32 @@ hlist_getstorage(anchor)
     return s;
 }
 
+/*
+ * Count the nodes in use in the hilite tree (or the filter tree),
+ * and the nodes allocated for it.  Return the bytes allocated.
+ */
+    public long
+hlist_usage(filter, pused, palloc)
+    int filter;
+    int *pused;
+    int *palloc;
+{
+    struct hilite_tree *anchor = filter ? &filter_anchor : &hilite_anchor;
+    struct hilite_storage *s;
+    int in_use = (anchor->current != NULL);
+
+    *pused = *palloc = 0;
+    for (s = anchor->first;  s != NULL;  s = s->next)
+    {
+        if (in_use)
+            *pused += s->used;
+        if (s == anchor->current)
+            in_use = FALSE;
+        *palloc += s->capacity;
+    }
+    return ((long) *palloc * sizeof(struct hilite_node));
+}
+
 /*
  * Tree node storage: retrieve a new empty node to be inserted into the
  * tree.
@@ -698,7 +1047,13 @@ hlist_getnode(anchor)
     struct hilite_tree *anchor;
 {
     struct hilite_storage *s = hlist_getstorage(anchor);
-    return &s->nodes[s->used++];
+    struct hilite_node *n = &s->nodes[s->used++];
+
+    /* The node may have been used before the tree was cleared. */
+    n->parent = n->left = n->right = NULL;
+    n->prev = n->next = NULL;
+    n->red = 0;
+    return n;
 }
 
 /*
@@ -947,7 +1302,8 @@ add_hilite(anchor, hl)
  * Highlight every character in a range of displayed characters.
  */
     static void
-create_hilites(linepos, start_index, end_index, chpos)
+create_hilites(anchor, linepos, start_index, end_index, chpos)
+    struct hilite_tree *anchor;
     POSITION linepos;
     int start_index;
     int end_index;
@@ -956,6 +1312,18 @@ create_hilites(linepos, start_index, end_index, chpos)
     struct hilite hl;
     int i;
 
+    if (chpos == NULL)
+    {
+        /* The line was not converted: the chars are all in place. */
+        if (end_index > start_index)
+        {
+            hl.hl_startpos = linepos + start_index;
+            hl.hl_endpos = linepos + end_index;
+            add_hilite(anchor, &hl);
+        }
+        return;
+    }
+
     /* Start the first hilite. */
     hl.hl_startpos = linepos + chpos[start_index];
 
@@ -972,7 +1340,7 @@ create_hilites(linepos, start_index, end_index, chpos)
         if (chpos[i] != chpos[i-1] + 1 || i == end_index)
         {
             hl.hl_endpos = linepos + chpos[i-1] + 1;
-            add_hilite(&hilite_anchor, &hl);
+            add_hilite(anchor, &hl);
             /* Start new hilite unless this is the last char. */
             if (i < end_index)
             {
@@ -984,11 +1352,13 @@ create_hilites(linepos, start_index, end_index, chpos)
 
 /*
  * Make a hilite for each string in a physical line which matches
- * the current pattern.
+ * a pattern.
  * sp,ep delimit the first match already found.
  */
     static void
-hilite_line(linepos, line, line_len, chpos, sp, ep, cvt_ops)
+hilite_line(anchor, info, linepos, line, line_len, chpos, sp, ep, cvt_ops)
+    struct hilite_tree *anchor;
+    struct pattern_info *info;
     POSITION linepos;
     char *line;
     int line_len;
@@ -1014,7 +1384,7 @@ hilite_line(linepos, line, line_len, chpos, sp, ep, cvt_ops)
     do {
         if (sp == NULL || ep == NULL)
             return;
-        create_hilites(linepos, sp-line, ep-line, chpos);
+        create_hilites(anchor, linepos, sp-line, ep-line, chpos);
         /*
          * If we matched more than zero characters,
          * move to the first char after the string we matched.
@@ -1026,8 +1396,93 @@ hilite_line(linepos, line, line_len, chpos, sp, ep, cvt_ops)
             searchp++;
         else /* end of line */
             break;
-    } while (match_pattern(info_compiled(&search_info), search_info.text,
-            searchp, line_end - searchp, &sp, &ep, 1, search_info.search_type));
+    } while (match_pattern(info_compiled(info), info->literal,
+            searchp, line_end - searchp, &sp, &ep, 1, info->search_type));
+}
+
+/*
+ * Scratch space for a line converted for highlight patterns
+ * whose caselessness differs from that of the search.
+ */
+static char *hl_cvt_buf = NULL;
+static int *hl_cvt_chpos = NULL;
+static size_t hl_cvt_size = 0;
+
+/*
+ * Make hilites for the matches of the highlight patterns in a line.
+ * raw is the line as read, and line is raw converted as cvt_ops say.
+ * A pattern which ignores case differently from the search is matched
+ * against raw converted again for it.
+ */
+    static void
+hilite_patterns(linepos, raw, raw_len, line, line_len, chpos, cvt_ops)
+    POSITION linepos;
+    char *raw;
+    int raw_len;
+    char *line;
+    int line_len;
+    int *chpos;
+    int cvt_ops;
+{
+    unsigned long found = 0;
+    char *sp, *ep;
+    char *hline;
+    int hline_len;
+    int *hchpos;
+    int ops;
+    int alt_len = -1;
+    int *alt_chpos = NULL;
+    size_t cvt_len;
+    int i;
+
+    if (hl_litset != NULL)
+        found = scan_litset(hl_litset, line, (size_t) line_len);
+    for (i = 0;  i < NUM_HIGHLIGHTS;  i++)
+    {
+        struct pattern_info *info = &hl_infos[i];
+        if (!prev_pattern(info))
+            continue;
+        ops = (cvt_ops & ~CVT_TO_LC) | caseless_cvt_ops(info->caseless);
+        if (ops == cvt_ops)
+        {
+            if (hl_litbit[i] >= 0 && !(found & (1UL << hl_litbit[i])))
+                /* The line lacks a string which every match contains. */
+                continue;
+            hline = line;
+            hline_len = line_len;
+            hchpos = chpos;
+        } else
+        {
+            /*
+             * The line was converted for the search, so the strings
+             * found in it say nothing about this pattern.
+             */
+            if (alt_len < 0)
+            {
+                cvt_len = cvt_length(raw_len, ops);
+                if (cvt_len > hl_cvt_size)
+                {
+                    if (hl_cvt_buf != NULL)
+                    {
+                        free(hl_cvt_buf);
+                        free(hl_cvt_chpos);
+                    }
+                    hl_cvt_buf = (char *) ecalloc(1, cvt_len);
+                    hl_cvt_chpos = (int *) ecalloc(sizeof(int), cvt_len);
+                    hl_cvt_size = cvt_len;
+                }
+                alt_len = raw_len;
+                alt_chpos = cvt_text(hl_cvt_buf, raw, hl_cvt_chpos, &alt_len, ops) ?
+                    NULL : hl_cvt_chpos;
+            }
+            hline = hl_cvt_buf;
+            hline_len = alt_len;
+            hchpos = alt_chpos;
+        }
+        if (match_pattern(info_compiled(info), info->literal,
+                hline, hline_len, &sp, &ep, 0, info->search_type))
+            hilite_line(&hl_anchors[i], info, linepos, hline, hline_len, hchpos, sp, ep, ops);
+    }
 }
 #endif
 
@@ -1166,11 +1621,10 @@ search_pos(search_type)
  */
 #if HILITE_SEARCH
     static int
-matches_filters(pos, cline, line_len, chpos, linepos, sp, ep)
+matches_filters(pos, cline, line_len, linepos, sp, ep)
     POSITION pos;
     char *cline;
     int line_len;
-    int *chpos;
     POSITION linepos;
     char **sp;
     char **ep;
@@ -1179,7 +1633,7 @@ matches_filters(pos, cline, line_len, chpos, linepos, sp, ep)
 
     for (filter = filter_infos; filter != NULL; filter = filter->next)
     {
-        int line_filter = match_pattern(info_compiled(filter), filter->text,
+        int line_filter = match_pattern(info_compiled(filter), filter->literal,
             cline, line_len, sp, ep, 0, filter->search_type);
         if (line_filter)
         {
@@ -1187,8 +1641,6 @@ matches_filters(pos, cline, line_len, chpos, linepos, sp, ep)
             hl.hl_startpos = linepos;
             hl.hl_endpos = pos;
             add_hilite(&filter_anchor, &hl);
-            free(cline);
-            free(chpos);
             return (1);
         }
     }
@@ -1196,60 +1648,1130 @@ matches_filters(pos, cline, line_len, chpos, linepos, sp, ep)
 }
 #endif
 
+#if HILITE_SEARCH
 /*
- * Get the position of the first char in the screen line which
- * puts tpos on screen.
+ * Add a hidden line to the end of the filter index,
+ * extending the last range if the line follows it.
  */
-    static POSITION
-get_lastlinepos(pos, tpos, sheight)
+    static void
+fx_add(linepos, pos)
+    POSITION linepos;
     POSITION pos;
-    POSITION tpos;
-    int sheight;
 {
-    int nlines;
-
-    for (nlines = 0;;  nlines++)
+    if (fx_nranges > 0 && fx_ranges[fx_nranges-1].hl_endpos == linepos)
     {
-        POSITION npos = forw_line(pos);
-        if (npos > tpos)
-        {
-            if (nlines < sheight)
-                return NULL_POSITION;
-            return pos;
-        }
-        pos = npos;
+        fx_ranges[fx_nranges-1].hl_endpos = pos;
+        return;
+    }
+    if (fx_nranges >= fx_maxranges)
+    {
+        int n = (fx_maxranges == 0) ? 64 : 2 * fx_maxranges;
+        struct hilite *r = (struct hilite *) ecalloc(n, sizeof(struct hilite));
+        if (fx_nranges > 0)
+            memcpy(r, fx_ranges, fx_nranges * sizeof(struct hilite));
+        if (fx_ranges != NULL)
+            free(fx_ranges);
+        fx_ranges = r;
+        fx_maxranges = n;
     }
+    fx_ranges[fx_nranges].hl_startpos = linepos;
+    fx_ranges[fx_nranges].hl_endpos = pos;
+    fx_nranges++;
 }
 
 /*
- * Get the segment index of tpos in the line starting at pos.
- * A segment is a string of printable chars that fills the screen width.
+ * Can the filter index be built for the current file?
  */
     static int
-get_seg(pos, tpos)
-    POSITION pos;
-    POSITION tpos;
+fx_usable(VOID_PARAM)
 {
-    int seg;
-
-    for (seg = 0;;  seg++)
-    {
-        POSITION npos = forw_line_seg(pos, FALSE, FALSE, TRUE);
-        if (npos > tpos)
-            return seg;
-        pos = npos;
-    }
+    if (!is_filtering() || ignore_eoi)
+        return (0);
+    if ((ch_getflags() & (CH_CANSEEK|CH_HELPFILE)) != CH_CANSEEK)
+        return (0);
+    return (ch_length() != NULL_POSITION);
 }
 
 /*
- * Search a subset of the file, specified by start/end position.
+ * Add some more of the file to the filter index.
+ * This is done while waiting for a command.
+ * Return nonzero if there is more of the file left to index.
  */
-    static int
-search_range(pos, endpos, search_type, matches, maxlines, plinepos, pendpos, plastlinepos)
+    public int
+filter_index_step(VOID_PARAM)
+{
+    POSITION len;
     POSITION pos;
-    POSITION endpos;
-    int search_type;
-    int matches;
+    POSITION linepos;
+    POSITION end;
+    POSITION save_pos;
+    char *line;
+    int line_len;
+    char *cline;
+    int *chpos;
+    char *sp, *ep;
+    int cvt_ops;
+    struct pattern_info *filter;
+    int hidden;
+
+    if (!fx_usable())
+        return (0);
+    len = ch_length();
+    cvt_ops = get_cvt_ops();
+    if (len < fx_pos || cvt_ops != fx_cvt_ops)
+    {
+        /* The file has shrunk, or lines are converted differently. */
+        clr_filter_index();
+        fx_cvt_ops = cvt_ops;
+    }
+    if (fx_pos >= len)
+        return (0);
+    save_pos = ch_tell();
+    end = fx_pos + FX_SLICE;
+    pos = fx_pos;
+    while (pos < end && !ABORT_SIGS())
+    {
+        linepos = pos;
+        pos = forw_match_line(pos, &line, &line_len);
+        if (pos == NULL_POSITION)
+            break;
+        cline = cvt_line(line, &line_len, cvt_ops, &chpos);
+        hidden = 0;
+        for (filter = filter_infos;  filter != NULL;  filter = filter->next)
+        {
+            if (match_pattern(info_compiled(filter), filter->literal,
+                    cline, line_len, &sp, &ep, 0, filter->search_type))
+            {
+                hidden = 1;
+                break;
+            }
+        }
+        if (hidden)
+            fx_add(linepos, pos);
+        else
+            fx_shown++;
+        fx_lines++;
+        fx_pos = pos;
+    }
+    if (save_pos != NULL_POSITION)
+        (void) ch_seek(save_pos);
+    return (fx_pos < len && pos != NULL_POSITION);
+}
+
+/*
+ * Get the number of lines shown by the filters and the number of
+ * lines in the file, if the filter index covers the whole file.
+ */
+    public int
+filter_counts(pshown, plines)
+    LINENUM *pshown;
+    LINENUM *plines;
+{
+    POSITION len;
+
+    if (!fx_usable() || fx_limit() == 0)
+        return (0);
+    len = ch_length();
+    if (fx_pos < len)
+        return (0);
+    *pshown = fx_shown;
+    *plines = fx_lines;
+    return (1);
+}
+#endif
+
+/*
+ * Get the position of the first char in the screen line which
+ * puts tpos on screen.
+ */
+    static POSITION
+get_lastlinepos(pos, tpos, sheight)
+    POSITION pos;
+    POSITION tpos;
+    int sheight;
+{
+    int nlines;
+
+    for (nlines = 0;;  nlines++)
+    {
+        POSITION npos = forw_line(pos);
+        if (npos > tpos)
+        {
+            if (nlines < sheight)
+                return NULL_POSITION;
+            return pos;
+        }
+        pos = npos;
+    }
+}
+
+/*
+ * Get the segment index of tpos in the line starting at pos.
+ * A segment is a string of printable chars that fills the screen width.
+ */
+    static int
+get_seg(pos, tpos)
+    POSITION pos;
+    POSITION tpos;
+{
+    int seg;
+
+    for (seg = 0;;  seg++)
+    {
+        POSITION npos = forw_line_seg(pos, FALSE, FALSE, TRUE);
+        if (npos > tpos)
+            return seg;
+        pos = npos;
+    }
+}
+
+/*
+ * Can a search skip ahead with skip_to_literal?
+ * The pattern must be, or contain, a literal string which is found in
+ * the raw bytes of a line exactly when it is found in the converted line.
+ * That holds for ASCII strings, except in lines where backspaces
+ * or escape sequences are removed; skip_to_literal stops before those.
+ * It does not hold for caseless strings with i, k or s in UTF-8 (below).
+ */
+    static int
+can_skip_literal(search_type, maxlines)
+    int search_type;
+    int maxlines;
+{
+    struct literal *lit = search_info.literal;
+    int i;
+
+    if (lit == NULL || lit->len == 0 || maxlines >= 0)
+        return (0);
+    if (!(search_type & SRCH_FORW) || (search_type & (SRCH_NO_MATCH|SRCH_FIND_ALL)))
+        return (0);
+    for (i = 0;  i < lit->len;  i++)
+    {
+        if (!IS_ASCII_OCTET(lit->text[i]) || lit->text[i] == '\r')
+            return (0);
+        /*
+         * The literal is looked for in the raw bytes, but a caseless
+         * search in UTF-8 matches some non-ASCII chars as ASCII letters:
+         * KELVIN SIGN (U+212A) as k, LATIN CAPITAL LETTER I WITH DOT
+         * ABOVE (U+0130) as i and, in regex libraries which fold case
+         * themselves, LATIN SMALL LETTER LONG S (U+017F) as s.
+         * A line with one of those would be skipped.
+         */
+        if (lit->caseless && utf_mode &&
+            strchr("iksIKS", lit->text[i]) != NULL)
+            return (0);
+    }
+    return (1);
+}
+
+/*
+ * Shorten a run of bytes to end before the first occurrence of a byte.
+ */
+    static int
+cut_span(p, n, c)
+    unsigned char *p;
+    int n;
+    int c;
+{
+    unsigned char *q = (unsigned char *) memchr(p, c, (size_t) n);
+    return (q == NULL) ? n : (int) (q - p);
+}
+
+/*
+ * Look for the literal search pattern, or the string which every match
+ * of the pattern contains, in the whole run of buffered text
+ * starting at pos, rather than a line at a time.
+ * Return the start of the line which contains it, or if it is not
+ * found, the start of the last line which begins in the run.
+ * Return pos if nothing can be skipped.
+ */
+    static POSITION
+skip_to_literal(pos, endpos)
+    POSITION pos;
+    POSITION endpos;
+{
+    unsigned char *p;
+    unsigned char *q;
+    char *found;
+    int cvt_ops;
+    int n;
+    int m;
+    int cut;
+
+    if (ch_seek(pos))
+        return (pos);
+    n = ch_forw_span(&p);
+    if (n > LIT_SPAN)
+        n = LIT_SPAN;
+    if (endpos != NULL_POSITION && endpos > pos && endpos - pos < n)
+        n = (int) (endpos - pos);
+    if (n <= 0)
+        return (pos);
+    if (pos >= lit_absent_start && pos < lit_absent_end && lit_absent_end - pos <= n)
+    {
+        /* An earlier call has looked through these bytes already. */
+        n = (int) (lit_absent_end - pos);
+        found = NULL;
+    } else
+    {
+        found = find_literal(search_info.literal, (char *) p, (size_t) n);
+        if (found == NULL)
+        {
+            lit_absent_start = pos;
+            lit_absent_end = pos + n;
+        }
+    }
+    /*
+     * Leave lines with text which conversion would remove
+     * to be searched normally.  Only the bytes up to the end
+     * of the string found need be checked.
+     */
+    m = (found != NULL) ? (int) (found - (char *) p) + search_info.literal->len : n;
+    cut = m;
+    cvt_ops = get_cvt_ops();
+    if (cvt_ops & CVT_BS)
+        cut = cut_span(p, cut, '\b');
+    if (cvt_ops & CVT_ANSI)
+    {
+        cut = cut_span(p, cut, ESC);
+        cut = cut_span(p, cut, CSI);
+    }
+    if (cut < m)
+    {
+        found = NULL;
+        n = cut;
+    }
+    q = (found != NULL) ? (unsigned char *) found : p + n;
+    /* Back up to the start of the line. */
+    while (q > p && q[-1] != '\n')
+        q--;
+    if (ch_span_lost())
+    {
+        /* The file was truncated under us; skip nothing. */
+        lit_absent_start = lit_absent_end = NULL_POSITION;
+        return (pos);
+    }
+    return (pos + (q - p));
+}
+
+/*
+ * Add a position to the end of a list.
+ * Return -1 if there is no memory for it.
+ * Search threads call this too, so it must not call ecalloc.
+ */
+    static int
+poslist_add(pl, pos)
+    struct poslist *pl;
+    POSITION pos;
+{
+    if (pl->npos >= pl->maxpos)
+    {
+        int n = (pl->maxpos == 0) ? 64 : 2 * pl->maxpos;
+        POSITION *p = (POSITION *) malloc(n * sizeof(POSITION));
+        if (p == NULL)
+            return (-1);
+        if (pl->npos > 0)
+            memcpy(p, pl->pos, pl->npos * sizeof(POSITION));
+        if (pl->pos != NULL)
+            free(pl->pos);
+        pl->pos = p;
+        pl->maxpos = n;
+    }
+    pl->pos[pl->npos++] = pos;
+    return (0);
+}
+
+/*
+ * Return the number of positions in a list which are before pos.
+ */
+    static int
+poslist_find(pl, pos)
+    struct poslist *pl;
+    POSITION pos;
+{
+    int lo = 0;
+    int hi = pl->npos;
+
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+        if (pl->pos[mid] < pos)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return (lo);
+}
+
+#if PSEARCH
+/*
+ * Parallel forward search.
+ * The range to be searched is cut into chunks, which are claimed in
+ * order by a number of threads.  Each thread reads lines directly from
+ * the memory mapping of the file, so the ch.c buffers are not touched,
+ * and tests them with its own conversion buffer.  A line belongs to the
+ * chunk in which it starts.  The earliest matching line wins; chunks
+ * after it are not searched.
+ * A counting search instead collects every matching line of each chunk
+ * in a list of its own; the lists are then joined in order.
+ */
+#define PS_CHUNK        (1024*1024)     /* Bytes claimed by a thread at once */
+#define PS_MIN          (4*PS_CHUNK)    /* Smallest range worth splitting */
+#define PS_MAXTHREADS   64
+
+struct psearch
+{
+    pthread_mutex_t lock;
+    unsigned char *data;            /* Mapped file */
+    POSITION start;                 /* First line to search */
+    POSITION end;                   /* Search lines starting before here */
+    POSITION next;                  /* Start of next unclaimed chunk */
+    POSITION found;                 /* Earliest matching line so far */
+    int search_type;
+    int cvt_ops;
+    int failed;                     /* A thread ran out of memory */
+    struct poslist *lists;          /* Matches in each chunk, if counting */
+    PATTERN_TYPE comps[PS_MAXTHREADS]; /* Copy of the pattern for each thread */
+    int ncomps;                     /* Copies taken by threads so far */
+};
+
+/*
+ * Body of a search thread.
+ */
+    static void *
+psearch_thread(arg)
+    void *arg;
+{
+    struct psearch *ps = (struct psearch *) arg;
+    unsigned char *nl;
+    char *line;
+    char *cline = NULL;
+    size_t cline_size = 0;
+    char *sp, *ep;
+    POSITION chunk, chunk_end;
+    POSITION linepos, lineend;
+    size_t cvt_len;
+    int line_len;
+    int len;
+    int nlines = 0;
+    PATTERN_TYPE comp;
+
+    pthread_mutex_lock(&ps->lock);
+    comp = ps->comps[ps->ncomps++];
+    pthread_mutex_unlock(&ps->lock);
+    for (;;)
+    {
+        /*
+         * Claim the next chunk, unless there is already
+         * a match before it.
+         */
+        pthread_mutex_lock(&ps->lock);
+        chunk = ps->next;
+        if (ps->failed || chunk >= ps->end ||
+            (ps->found != NULL_POSITION && chunk > ps->found))
+            chunk = NULL_POSITION;
+        else
+            ps->next += PS_CHUNK;
+        pthread_mutex_unlock(&ps->lock);
+        if (chunk == NULL_POSITION || ABORT_SIGS())
+            break;
+        chunk_end = MINPOS(chunk + PS_CHUNK, ps->end);
+
+        /*
+         * Find the first line which starts in the chunk.
+         */
+        linepos = chunk;
+        if (chunk > ps->start)
+        {
+            nl = (unsigned char *) memchr(ps->data + chunk - 1, '\n',
+                (size_t) (chunk_end - chunk + 1));
+            if (nl == NULL)
+                continue;
+            linepos = (POSITION) (nl - ps->data) + 1;
+        }
+
+        while (linepos < chunk_end)
+        {
+            /*
+             * Range ends at a line boundary, so every line
+             * in it ends with a newline.
+             */
+            nl = (unsigned char *) memchr(ps->data + linepos, '\n',
+                (size_t) (ps->end - linepos));
+            if (nl == NULL)
+            {
+                /* The file was truncated under the mapping. */
+                pthread_mutex_lock(&ps->lock);
+                ps->failed = 1;
+                pthread_mutex_unlock(&ps->lock);
+                break;
+            }
+            lineend = (POSITION) (nl - ps->data);
+            line = (char *) ps->data + linepos;
+            line_len = (int) (lineend - linepos);
+            len = cvt_unchanged(line, line_len, ps->cvt_ops);
+            if (len >= 0 && re_uses_length)
+            {
+                /* Match the line where it is in the mapping. */
+                line_len = len;
+            } else
+            {
+                cvt_len = cvt_length(line_len, ps->cvt_ops);
+                if (cvt_len > cline_size)
+                {
+                    if (cline != NULL)
+                        free(cline);
+                    cline_size = cvt_len + 256;
+                    cline = (char *) malloc(cline_size);
+                    if (cline == NULL)
+                    {
+                        pthread_mutex_lock(&ps->lock);
+                        ps->failed = 1;
+                        pthread_mutex_unlock(&ps->lock);
+                        return (NULL);
+                    }
+                }
+                cvt_text(cline, line, (int *) NULL, &line_len, ps->cvt_ops);
+                line = cline;
+            }
+            if (match_pattern(comp, search_info.literal,
+                    line, line_len, &sp, &ep, 0, ps->search_type))
+            {
+                if (ps->lists != NULL)
+                {
+                    /*
+                     * Counting: record the line and go on.
+                     */
+                    if (poslist_add(&ps->lists[(chunk - ps->start) / PS_CHUNK], linepos) < 0)
+                    {
+                        pthread_mutex_lock(&ps->lock);
+                        ps->failed = 1;
+                        pthread_mutex_unlock(&ps->lock);
+                        break;
+                    }
+                } else
+                {
+                    pthread_mutex_lock(&ps->lock);
+                    if (ps->found == NULL_POSITION || linepos < ps->found)
+                        ps->found = linepos;
+                    pthread_mutex_unlock(&ps->lock);
+                    break;
+                }
+            }
+            linepos = lineend + 1;
+            if (++nlines % 1024 == 0 && ABORT_SIGS())
+                break;
+        }
+    }
+    if (cline != NULL)
+        free(cline);
+    return (NULL);
+}
+
+/*
+ * Run the search threads over the range described by ps.
+ */
+    static void
+psearch_run(ps)
+    struct psearch *ps;
+{
+    pthread_t threads[PS_MAXTHREADS];
+    sigset_t mask, omask;
+    int nthreads;
+    int ncopies;
+    int i;
+
+    /*
+     * Give each thread its own copy of the pattern,
+     * compiled with the caselessness set_pattern used for it,
+     * and lowercase the lines to match it the same way.
+     */
+    nthreads = MINPOS(search_threads, PS_MAXTHREADS);
+    ps->cvt_ops = (ps->cvt_ops & ~CVT_TO_LC) | caseless_cvt_ops(search_info.caseless);
+    for (i = 0;  i < nthreads;  i++)
+        if (thread_pattern(info_compiled(&search_info), search_info.text,
+                search_info.search_type, search_info.caseless, &ps->comps[i]) < 0)
+            break;
+    ncopies = nthreads = i;
+    if (nthreads == 0)
+    {
+        ps->failed = 1;
+        return;
+    }
+    ps->ncomps = 0;
+
+    pthread_mutex_init(&ps->lock, NULL);
+    /*
+     * Signals are handled by this thread only,
+     * except for a bus error in the mapping (see ch_sigbus),
+     * which goes to the thread which caused it.
+     */
+    sigfillset(&mask);
+#ifdef SIGBUS
+    sigdelset(&mask, SIGBUS);
+#endif
+    pthread_sigmask(SIG_BLOCK, &mask, &omask);
+    for (i = 0;  i < nthreads - 1;  i++)
+        if (pthread_create(&threads[i], NULL, psearch_thread, ps) != 0)
+            break;
+    pthread_sigmask(SIG_SETMASK, &omask, NULL);
+    nthreads = i;
+    (void) psearch_thread(ps);
+    for (i = 0;  i < nthreads;  i++)
+        pthread_join(threads[i], NULL);
+    pthread_mutex_destroy(&ps->lock);
+    for (i = 0;  i < ncopies;  i++)
+        free_thread_pattern(&ps->comps[i]);
+}
+
+/*
+ * Can a search be done with psearch?
+ */
+    static int
+can_psearch(search_type, maxlines)
+    int search_type;
+    int maxlines;
+{
+    if (search_threads <= 1 || maxlines >= 0)
+        return (0);
+    if (!(search_type & SRCH_FORW) || (search_type & (SRCH_NO_MATCH|SRCH_FIND_ALL)))
+        return (0);
+    if (!(search_type & SRCH_NO_REGEX) && !re_reentrant)
+        return (0);
+    return (prev_pattern(&search_info));
+}
+
+/*
+ * Search lines starting at pos (and before endpos, if given)
+ * using several threads.
+ * Return the position of the first matching line, or the position
+ * where the search should continue if there is no match.
+ * Return pos if the range cannot be searched in parallel.
+ */
+    static POSITION
+psearch(pos, endpos, search_type)
+    POSITION pos;
+    POSITION endpos;
+    int search_type;
+{
+    struct psearch ps;
+    unsigned char *data;
+    POSITION len;
+    POSITION end;
+
+    data = ch_mapped(&len);
+    if (data == NULL)
+        return (pos);
+    end = len;
+    if (endpos != NULL_POSITION && endpos < end)
+        end = endpos;
+    /*
+     * End the range after the last newline, so that the
+     * threads do not need to look past it.
+     */
+    while (end > pos && data[end-1] != '\n')
+        end--;
+    if (end - pos < PS_MIN)
+        return (pos);
+
+    ps.data = data;
+    ps.start = ps.next = pos;
+    ps.end = end;
+    ps.found = NULL_POSITION;
+    ps.search_type = search_type;
+    ps.cvt_ops = get_cvt_ops();
+    ps.failed = 0;
+    ps.lists = NULL;
+    psearch_run(&ps);
+
+    if (ps.failed || ABORT_SIGS() || ch_mapped(&len) != data)
+        return (pos);
+    if (ps.found != NULL_POSITION)
+        return (ps.found);
+    return (end);
+}
+#endif
+
+/*
+ * Discard the match index.
+ */
+    public void
+clr_match_index(VOID_PARAM)
+{
+    mx_list.npos = 0;
+    mx_pos = NULL_POSITION;
+}
+
+#if PSEARCH
+/*
+ * Find every matching line which starts in the mapped file
+ * between pos and end, using several threads,
+ * and add their positions to a list in order.
+ * The range must end just after a newline.
+ * Return -1 if the search is interrupted or runs out of memory;
+ * some of the lines may have been added to the list.
+ */
+    static int
+psearch_all(data, pos, end, search_type, cvt_ops, pl)
+    unsigned char *data;
+    POSITION pos;
+    POSITION end;
+    int search_type;
+    int cvt_ops;
+    struct poslist *pl;
+{
+    struct psearch ps;
+    POSITION len;
+    int nlists;
+    int r = 0;
+    int i, j;
+
+    nlists = (int) ((end - pos + PS_CHUNK - 1) / PS_CHUNK);
+    ps.lists = (struct poslist *) ecalloc(nlists, sizeof(struct poslist));
+    ps.data = data;
+    ps.start = ps.next = pos;
+    ps.end = end;
+    ps.found = NULL_POSITION;
+    ps.search_type = search_type;
+    ps.cvt_ops = cvt_ops;
+    ps.failed = 0;
+    psearch_run(&ps);
+
+    /*
+     * An interrupted search leaves gaps in the lists,
+     * so they are only used if every chunk was searched.
+     * Nor are they used if the file was truncated meanwhile.
+     */
+    if (ps.failed || ABORT_SIGS() || ch_mapped(&len) != data)
+        r = -1;
+    for (i = 0;  i < nlists;  i++)
+    {
+        for (j = 0;  j < ps.lists[i].npos && r == 0;  j++)
+            if (poslist_add(pl, ps.lists[i].pos[j]) < 0)
+                r = -1;
+        if (ps.lists[i].pos != NULL)
+            free(ps.lists[i].pos);
+    }
+    free(ps.lists);
+    return (r);
+}
+
+/*
+ * Index the lines in the mapped part of the file from pos onward,
+ * using several threads.
+ * Return the position where indexing should continue,
+ * which is pos if the range cannot be indexed in parallel.
+ */
+    static POSITION
+mx_psearch(pos)
+    POSITION pos;
+{
+    unsigned char *data;
+    POSITION len;
+    POSITION end;
+    int npos;
+
+    if (search_threads <= 1)
+        return (pos);
+#if HILITE_SEARCH
+    /* The threads don't apply the filters. */
+    if (filter_infos != NULL)
+        return (pos);
+#endif
+    if (!(search_info.search_type & SRCH_NO_REGEX) && !re_reentrant)
+        return (pos);
+    data = ch_mapped(&len);
+    if (data == NULL)
+        return (pos);
+    end = len;
+    while (end > pos && data[end-1] != '\n')
+        end--;
+    if (end - pos < PS_MIN)
+        return (pos);
+
+    npos = mx_list.npos;
+    if (psearch_all(data, pos, end, SRCH_FORW | (mx_no_match ? SRCH_NO_MATCH : 0),
+            mx_cvt_ops, &mx_list) < 0)
+    {
+        mx_list.npos = npos;
+        return (pos);
+    }
+    return (end);
+}
+#endif
+
+/*
+ * Bring the match index up to the end of the file.
+ * Return -1 if this is interrupted or runs out of memory.
+ */
+    static int
+mx_extend(search_type)
+    int search_type;
+{
+    POSITION len;
+    POSITION pos;
+    POSITION linepos;
+    POSITION save_pos;
+    char *line;
+    int line_len;
+    char *cline;
+    int *chpos;
+    char *sp, *ep;
+    int cvt_ops;
+    int no_match;
+    int matched;
+    int r = 0;
+#if HILITE_SEARCH
+    struct pattern_info *filter;
+#endif
+
+    cvt_ops = get_cvt_ops();
+    no_match = (search_type & SRCH_NO_MATCH) != 0;
+    len = ch_length();
+    if (mx_pos == NULL_POSITION || cvt_ops != mx_cvt_ops ||
+        no_match != mx_no_match || (len != NULL_POSITION && len < mx_pos))
+    {
+        /*
+         * There is no index yet, or the lines are matched
+         * differently now, or the file has shrunk.
+         */
+        clr_match_index();
+        mx_pos = ch_zero();
+        mx_cvt_ops = cvt_ops;
+        mx_no_match = no_match;
+    }
+#if PSEARCH
+    mx_pos = mx_psearch(mx_pos);
+#endif
+    save_pos = ch_tell();
+    pos = mx_pos;
+    for (;;)
+    {
+        if (ABORT_SIGS())
+        {
+            r = -1;
+            break;
+        }
+        linepos = pos;
+        pos = forw_match_line(pos, &line, &line_len);
+        if (pos == NULL_POSITION)
+            break;
+        cline = cvt_line(line, &line_len, cvt_ops, &chpos);
+        matched = 1;
+#if HILITE_SEARCH
+        for (filter = filter_infos;  filter != NULL;  filter = filter->next)
+        {
+            if (match_pattern(info_compiled(filter), filter->literal,
+                    cline, line_len, &sp, &ep, 0, filter->search_type))
+            {
+                matched = 0;
+                break;
+            }
+        }
+#endif
+        if (matched)
+            matched = match_pattern(info_compiled(&search_info), search_info.literal,
+                cline, line_len, &sp, &ep, 0, search_type);
+        if (matched && poslist_add(&mx_list, linepos) < 0)
+        {
+            error("Cannot allocate memory", NULL_PARG);
+            clr_match_index();
+            r = -1;
+            break;
+        }
+        mx_pos = pos;
+    }
+    if (save_pos != NULL_POSITION)
+        (void) ch_seek(save_pos);
+    return (r);
+}
+
+/*
+ * Find the n-th matching line from pos in the match index,
+ * the same way search_range would find it by reading the file.
+ * Return the number of matches not found, or -1 if interrupted.
+ */
+    static int
+mx_search(pos, search_type, n, plinepos)
+    POSITION pos;
+    int search_type;
+    int n;
+    POSITION *plinepos;
+{
+    int before;
+    int after;
+    int i;
+
+    if (mx_extend(search_type) < 0)
+        return (-1);
+    before = poslist_find(&mx_list, pos);
+    after = mx_list.npos - before;
+    if (search_type & SRCH_FORW)
+    {
+        if (n <= after)
+            i = before + n - 1;
+        else if ((search_type & SRCH_WRAP) && n - after <= before)
+            i = n - after - 1;
+        else
+            return (n - after - ((search_type & SRCH_WRAP) ? before : 0));
+    } else
+    {
+        if (n <= before)
+            i = before - n;
+        else if ((search_type & SRCH_WRAP) && n - before <= after)
+            i = mx_list.npos - (n - before);
+        else
+            return (n - before - ((search_type & SRCH_WRAP) ? after : 0));
+    }
+    *plinepos = mx_list.pos[i];
+    return (0);
+}
+
+/*
+ * Get the number of matching lines at or before the target line,
+ * and the number of matching lines in the file, if it has been indexed.
+ * Return 0 if there is no index, 1 if the whole file is indexed,
+ * or 2 if the count was interrupted or the file has grown since,
+ * so that *pn is only the number of matching lines found so far.
+ */
+    public int
+match_counts(pk, pn)
+    int *pk;
+    int *pn;
+{
+    POSITION pos;
+    POSITION len;
+
+    if (mx_pos == NULL_POSITION || !prev_pattern(&search_info))
+        return (0);
+    pos = position(sindex_from_sline(jump_sline));
+    *pk = (pos == NULL_POSITION) ? 0 : poslist_find(&mx_list, pos + 1);
+    *pn = mx_list.npos;
+    len = ch_length();
+    if (len == NULL_POSITION || mx_pos < len)
+        return (2);
+    return (1);
+}
+
+/*
+ * Set the pattern used by grep_file.
+ * The N and R search options apply to it.
+ */
+    public int
+set_grep_pattern(pattern)
+    char *pattern;
+{
+    return (set_search_pattern(&search_info, pattern,
+        SRCH_FORW | (def_search_type & (SRCH_NO_MATCH|SRCH_NO_REGEX)), 1));
+}
+
+/*
+ * Does the file have a newline just before pos?
+ */
+    static int
+ends_line(pos)
+    POSITION pos;
+{
+    return (pos > ch_zero() && ch_seek(pos - 1) == 0 && ch_forw_get() == '\n');
+}
+
+/*
+ * Write the matching lines from pos to the end of the file,
+ * or every line if there is no grep pattern.
+ * If keep_last is set, an unfinished last line is left to be
+ * read again when the rest of it has been written.
+ * Return the position after the last line read.
+ */
+    static POSITION
+grep_lines(pos, keep_last)
+    POSITION pos;
+    int keep_last;
+{
+    char *line;
+    int line_len;
+    char *cline;
+    int cvt_len;
+    int *chpos;
+    char *sp, *ep;
+    POSITION linepos;
+    POSITION npos;
+    POSITION skipped = NULL_POSITION;
+    int use_pattern;
+    int matched;
+    int use_skip;
+    int cvt_ops;
+
+    use_pattern = prev_pattern(&search_info);
+    use_skip = can_skip_literal(search_info.search_type, -1);
+    lit_absent_start = lit_absent_end = NULL_POSITION;
+    cvt_ops = get_cvt_ops();
+    for (;;)
+    {
+        if (ABORT_SIGS())
+            break;
+        if (use_skip && pos != skipped)
+        {
+            npos = skip_to_literal(pos, NULL_POSITION);
+            if (npos != pos)
+            {
+                pos = skipped = npos;
+                continue;
+            }
+        }
+        linepos = pos;
+        pos = forw_match_line(pos, &line, &line_len);
+        if (pos == NULL_POSITION || screen_trashed == 2)
+        {
+            /* End of file, or the file is being replaced (see ch_get). */
+            pos = linepos;
+            break;
+        }
+        if (keep_last && pos == ch_length() && !ends_line(pos))
+        {
+            pos = linepos;
+            break;
+        }
+        if (use_pattern)
+        {
+            cvt_len = line_len;
+            cline = cvt_line(line, &cvt_len, cvt_ops, &chpos);
+            matched = match_pattern(info_compiled(&search_info), search_info.literal,
+                cline, cvt_len, &sp, &ep, 0, search_info.search_type);
+            if (!matched)
+                continue;
+        }
+        putbytes(line, line_len);
+        putchr('\n');
+    }
+    return (pos);
+}
+
+#if PSEARCH
+#define GREP_WINDOW     (64*PS_CHUNK)   /* Bytes searched before writing */
+
+/*
+ * Write the matching lines in the mapped part of the file from pos onward,
+ * using several threads.  The file is searched a window at a time,
+ * so the lines are written while the search goes on.
+ * Return the position where the search should continue.
+ */
+    static POSITION
+grep_psearch(pos)
+    POSITION pos;
+{
+    struct poslist pl;
+    unsigned char *data;
+    unsigned char *nl;
+    POSITION len;
+    POSITION end;
+    int i;
+
+    if (search_threads <= 1 || !prev_pattern(&search_info))
+        return (pos);
+    if (!(search_info.search_type & SRCH_NO_REGEX) && !re_reentrant)
+        return (pos);
+    /* As in search_range, skipping to a literal string is faster. */
+    if (can_skip_literal(search_info.search_type, -1))
+        return (pos);
+    data = ch_mapped(&len);
+    if (data == NULL)
+        return (pos);
+    pl.pos = NULL;
+    pl.npos = pl.maxpos = 0;
+    for (;;)
+    {
+        end = MINPOS(pos + GREP_WINDOW, len);
+        while (end > pos && data[end-1] != '\n')
+            end--;
+        if (end - pos < PS_MIN)
+            break;
+        pl.npos = 0;
+        if (psearch_all(data, pos, end, search_info.search_type,
+                get_cvt_ops(), &pl) < 0)
+            break;
+        for (i = 0;  i < pl.npos;  i++)
+        {
+            nl = (unsigned char *) memchr(data + pl.pos[i], '\n',
+                (size_t) (end - pl.pos[i]));
+            if (nl == NULL || ch_span_lost())
+                break;
+            putbytes((char *) data + pl.pos[i], (int) (nl - data - pl.pos[i]) + 1);
+        }
+        if (i < pl.npos)
+        {
+            /* Let grep_lines read the rest from the file. */
+            pos = pl.pos[i];
+            break;
+        }
+        pos = end;
+    }
+    if (pl.pos != NULL)
+        free(pl.pos);
+    return (pos);
+}
+#endif
+
+/*
+ * Write the lines of the current file which match the grep pattern,
+ * or every line if there is none, to standard output.
+ * If follow is set, go on writing lines as they are added to the file,
+ * like the F command.
+ */
+    public void
+grep_file(follow)
+    int follow;
+{
+    POSITION pos;
+
+    pos = ch_zero();
+#if PSEARCH
+    pos = grep_psearch(pos);
+#endif
+    pos = grep_lines(pos, follow);
+    if (follow)
+    {
+        ignore_eoi = 1;
+        for (;;)
+        {
+            pos = grep_lines(pos, FALSE);
+            if (screen_trashed != 2 || ABORT_SIGS())
+                break;
+            /*
+             * The file has been replaced or truncated:
+             * start again at the beginning of the new one.
+             */
+            screen_trashed = 0;
+            reopen_curr_ifile();
+            pos = ch_zero();
+        }
+        ignore_eoi = 0;
+    }
+    flush();
+}
+
+/*
+ * Are matches of the search pattern wanted when preparing hilites?
+ * Otherwise hilites are prepared only for the highlight patterns.
+ */
+    static int
+prep_search_hilites(VOID_PARAM)
+{
+#if HILITE_SEARCH
+    return (hilite_search == OPT_ONPLUS || is_filtering() || status_col);
+#else
+    return (0);
+#endif
+}
+
+/*
+ * Search a subset of the file, specified by start/end position.
+ */
+    static int
+search_range(pos, endpos, search_type, matches, maxlines, plinepos, pendpos, plastlinepos)
+    POSITION pos;
+    POSITION endpos;
+    int search_type;
+    int matches;
     int maxlines;
     POSITION *plinepos;
     POSITION *pendpos;
@@ -1258,18 +2780,29 @@ search_range(pos, endpos, search_type, matches, maxlines, plinepos, pendpos, pla
     char *line;
     char *cline;
     int line_len;
+    int raw_len;
     LINENUM linenum;
     char *sp, *ep;
     int line_match;
     int cvt_ops;
-    size_t cvt_len;
     int *chpos;
     POSITION linepos, oldpos;
+    POSITION npos;
+    POSITION skipped = NULL_POSITION;
+    int use_skip;
+#if PSEARCH
+    int use_psearch;
+#endif
     int swidth = sc_width - line_pfx_width();
     int sheight = sc_height - sindex_from_sline(jump_sline);
 
     linenum = find_linenum(pos);
     oldpos = pos;
+    use_skip = can_skip_literal(search_type, maxlines);
+    lit_absent_start = lit_absent_end = NULL_POSITION;
+#if PSEARCH
+    use_psearch = !use_skip && can_psearch(search_type, maxlines);
+#endif
     /* When the search wraps around, end at starting position. */
     if ((search_type & SRCH_WRAP) && endpos == NULL_POSITION)
         endpos = pos;
@@ -1302,6 +2835,41 @@ search_range(pos, endpos, search_type, matches, maxlines, plinepos, pendpos, pla
         if (maxlines > 0)
             maxlines--;
 
+        if (use_skip && pos != skipped)
+        {
+            /*
+             * Skip ahead to the next line that contains the
+             * literal string, which is then checked below
+             * like any other line.
+             */
+            npos = skip_to_literal(pos,
+                (search_type & SRCH_WRAP) ? NULL_POSITION : endpos);
+            if (npos != pos)
+            {
+                pos = skipped = npos;
+                /* Don't spend time counting the lines we skipped. */
+                linenum = 0;
+                continue;
+            }
+        }
+#if PSEARCH
+        if (use_psearch && pos != skipped)
+        {
+            /*
+             * Likewise, let several threads find the next line
+             * that matches.
+             */
+            npos = psearch(pos,
+                (search_type & SRCH_WRAP) ? NULL_POSITION : endpos, search_type);
+            if (npos != pos)
+            {
+                pos = skipped = npos;
+                linenum = 0;
+                continue;
+            }
+            use_psearch = FALSE;
+        }
+#endif
         if (search_type & SRCH_FORW)
         {
             /*
@@ -1309,7 +2877,7 @@ search_range(pos, endpos, search_type, matches, maxlines, plinepos, pendpos, pla
              * starting position of that line in linepos.
              */
             linepos = pos;
-            pos = forw_raw_line(pos, &line, &line_len);
+            pos = forw_match_line(pos, &line, &line_len);
             if (linenum != 0)
                 linenum++;
         } else
@@ -1355,6 +2923,9 @@ search_range(pos, endpos, search_type, matches, maxlines, plinepos, pendpos, pla
                      */
                     search_type &= ~SRCH_WRAP;
                     linenum = find_linenum(pos);
+#if PSEARCH
+                    use_psearch = !use_skip && can_psearch(search_type, maxlines);
+#endif
                     continue;
                 }
             }
@@ -1371,7 +2942,7 @@ search_range(pos, endpos, search_type, matches, maxlines, plinepos, pendpos, pla
          * the search.  Remember the line number only if
          * we're "far" from the last place we remembered it.
          */
-        if (linenums && abs((int)(pos - oldpos)) > 2048)
+        if (linenums && linenum != 0 && abs((int)(pos - oldpos)) > 2048)
             add_lnum(linenum, pos);
         oldpos = pos;
 
@@ -1385,10 +2956,8 @@ search_range(pos, endpos, search_type, matches, maxlines, plinepos, pendpos, pla
          * If we're doing backspace processing, delete backspaces.
          */
         cvt_ops = get_cvt_ops();
-        cvt_len = cvt_length(line_len, cvt_ops);
-        cline = (char *) ecalloc(1, cvt_len);
-        chpos = cvt_alloc_chpos(cvt_len);
-        cvt_text(cline, line, chpos, &line_len, cvt_ops);
+        raw_len = line_len;
+        cline = cvt_line(line, &line_len, cvt_ops, &chpos);
 
 #if HILITE_SEARCH
         /*
@@ -1398,9 +2967,15 @@ search_range(pos, endpos, search_type, matches, maxlines, plinepos, pendpos, pla
            ((search_type & SRCH_FIND_ALL) ||
              prep_startpos == NULL_POSITION ||
              linepos < prep_startpos || linepos >= prep_endpos)) {
-            if (matches_filters(pos, cline, line_len, chpos, linepos, &sp, &ep))
+            if (matches_filters(pos, cline, line_len, linepos, &sp, &ep))
                 continue;
         }
+
+        /*
+         * When preparing hilites, also find the highlight patterns.
+         */
+        if ((search_type & SRCH_FIND_ALL) && hl_count > 0)
+            hilite_patterns(linepos, line, raw_len, cline, line_len, chpos, cvt_ops);
 #endif
 
         /*
@@ -1408,9 +2983,10 @@ search_range(pos, endpos, search_type, matches, maxlines, plinepos, pendpos, pla
          * We are successful if we either want a match and got one,
          * or if we want a non-match and got one.
          */
-        if (prev_pattern(&search_info))
+        if (prev_pattern(&search_info) &&
+            (!(search_type & SRCH_FIND_ALL) || prep_search_hilites()))
         {
-            line_match = match_pattern(info_compiled(&search_info), search_info.text,
+            line_match = match_pattern(info_compiled(&search_info), search_info.literal,
                 cline, line_len, &sp, &ep, 0, search_type);
             if (line_match)
             {
@@ -1425,7 +3001,7 @@ search_range(pos, endpos, search_type, matches, maxlines, plinepos, pendpos, pla
                      * Just add the matches in this line to the
                      * hilite list and keep searching.
                      */
-                    hilite_line(linepos, cline, line_len, chpos, sp, ep, cvt_ops);
+                    hilite_line(&hilite_anchor, &search_info, linepos, cline, line_len, chpos, sp, ep, cvt_ops);
 #endif
                 } else if (--matches <= 0)
                 {
@@ -1441,7 +3017,7 @@ search_range(pos, endpos, search_type, matches, maxlines, plinepos, pendpos, pla
                          * the matches in this one line.
                          */
                         clr_hilite();
-                        hilite_line(linepos, cline, line_len, chpos, sp, ep, cvt_ops);
+                        hilite_line(&hilite_anchor, &search_info, linepos, cline, line_len, chpos, sp, ep, cvt_ops);
                     }
 #endif
                     if (chop_line())
@@ -1458,8 +3034,8 @@ search_range(pos, endpos, search_type, matches, maxlines, plinepos, pendpos, pla
                             int sshift;
                             int eshift;
                             hshift = 0; /* make get_seg count screen lines */
-                            sshift = swidth * get_seg(linepos, linepos + chpos[start_off]);
-                            eshift = swidth * get_seg(linepos, linepos + chpos[end_off]);
+                            sshift = swidth * get_seg(linepos, linepos + cvt_srcpos(chpos, start_off));
+                            eshift = swidth * get_seg(linepos, linepos + cvt_srcpos(chpos, end_off));
                             if (sshift >= save_hshift && eshift <= save_hshift)
                             {
                                 hshift = save_hshift;
@@ -1483,19 +3059,15 @@ search_range(pos, endpos, search_type, matches, maxlines, plinepos, pendpos, pla
                         {
                             POSITION end_off = (POSITION)(ep - cline);
                             if (end_off >= swidth * sheight / 4) /* heuristic */
-                                *plastlinepos = get_lastlinepos(linepos, linepos + chpos[end_off], sheight);
+                                *plastlinepos = get_lastlinepos(linepos, linepos + cvt_srcpos(chpos, end_off), sheight);
                         }
                     }
-                    free(cline);
-                    free(chpos);
                     if (plinepos != NULL)
                         *plinepos = linepos;
                     return (0);
                 }
             }
         }
-        free(cline);
-        free(chpos);
     }
 }
 
@@ -1514,8 +3086,9 @@ hist_pattern(search_type)
     if (pattern == NULL)
         return (0);
 
-    if (set_pattern(&search_info, pattern, search_type, 1) < 0)
+    if (set_search_pattern(&search_info, pattern, search_type, 1) < 0)
         return (-1);
+    clr_match_index();
 
 #if HILITE_SEARCH
     if (hilite_search == OPT_ONPLUS && !hide_hilite)
@@ -1547,8 +3120,17 @@ chg_caseless(VOID_PARAM)
          * the pattern which was compiled with the old caseless.
          */
         if (!re_handles_caseless)
-            /* We handle caseless, so the pattern doesn't change. */
+        {
+            /*
+             * We handle caseless, so the pattern doesn't change,
+             * but the literal string compiled from it does.
+             */
+            search_info.caseless = is_caseless;
+            uncompile_literal(&search_info.literal);
+            search_info.literal = compile_literal(search_info.text,
+                search_info.search_type, is_caseless);
             return;
+        }
     }
     /*
      * Regenerate the pattern using the new state.
@@ -1622,8 +3204,9 @@ search(search_type, pattern, n)
          * Compile the pattern.
          */
         int show_error = !(search_type & SRCH_INCR);
-        if (set_pattern(&search_info, pattern, search_type, show_error) < 0)
+        if (set_search_pattern(&search_info, pattern, search_type, show_error) < 0)
             return (-1);
+        clr_match_index();
 #if HILITE_SEARCH
         if (hilite_search || status_col)
         {
@@ -1666,8 +3249,21 @@ search(search_type, pattern, n)
         return (-1);
     }
 
-    n = search_range(pos, NULL_POSITION, search_type, n, -1,
-            &pos, (POSITION*)NULL, &lastlinepos);
+    if (search_type & SRCH_COUNT)
+    {
+        /*
+         * Find the matching line in the match index.
+         * Then search just that line, so that it is highlighted
+         * and shifted into view as in any other search.
+         */
+        n = mx_search(pos, search_type, n, &pos);
+        if (n == 0)
+            (void) search_range(pos, NULL_POSITION,
+                (search_type & ~(SRCH_BACK|SRCH_WRAP)) | SRCH_FORW, 1, 1,
+                &pos, (POSITION*)NULL, &lastlinepos);
+    } else
+        n = search_range(pos, NULL_POSITION, search_type, n, -1,
+                &pos, (POSITION*)NULL, &lastlinepos);
     if (n != 0)
     {
         /*
@@ -1734,7 +3330,14 @@ prep_hilite(spos, epos, maxlines)
  */
 #define SEARCH_MORE (3*size_linebuf)
 
-    if (!prev_pattern(&search_info) && !is_filtering())
+    if (!prev_pattern(&search_info) && !is_filtering() && hl_count == 0)
+        return;
+    if (!prev_pattern(&search_info) && hl_count == 0 &&
+        epos != NULL_POSITION && epos <= fx_limit())
+        /*
+         * Only filtering, and the filter index already
+         * knows which lines in the region are hidden.
+         */
         return;
 
     /*
@@ -1770,7 +3373,10 @@ prep_hilite(spos, epos, maxlines)
          * New range is not contiguous with old prep region.
          * Discard the old prep region and start a new one.
          */
-        clr_hilite();
+        if (prep_search_hilites())
+            clr_hilite();
+        else
+            clr_highlights();
         clr_filter();
         if (epos != NULL_POSITION)
             epos += SEARCH_MORE;
@@ -1893,6 +3499,8 @@ set_filter_pattern(pattern, search_type)
     struct pattern_info *filter;
 
     clr_filter();
+    clr_filter_index();
+    clr_match_index();
     if (pattern == NULL || *pattern == '\0')
     {
         /* Clear and free all filters. */
@@ -1909,7 +3517,7 @@ set_filter_pattern(pattern, search_type)
         /* Create a new filter and add it to the filter_infos list. */
         filter = ecalloc(1, sizeof(struct pattern_info));
         init_pattern(filter);
-        if (set_pattern(filter, pattern, search_type, 1) < 0)
+        if (set_search_pattern(filter, pattern, search_type, 1) < 0)
         {
             free(filter);
             return;
@@ -1920,6 +3528,92 @@ set_filter_pattern(pattern, search_type)
     screen_trashed = 1;
 }
 
+/*
+ * Set highlight pattern n (1 to NUM_HIGHLIGHTS),
+ * or the first one not in use if n is 0.
+ * An empty pattern clears highlight n, or all of them if n is 0.
+ */
+    public void
+set_highlight_pattern(n, pattern, search_type)
+    int n;
+    char *pattern;
+    int search_type;
+{
+    struct literal *lits[NUM_HIGHLIGHTS];
+    int nlits;
+    int i;
+    PARG parg;
+
+    if (n < 0 || n > NUM_HIGHLIGHTS)
+    {
+        parg.p_int = NUM_HIGHLIGHTS;
+        error("Highlight number must be 1 to %d", &parg);
+        return;
+    }
+    if (pattern == NULL || *pattern == '\0')
+    {
+        for (i = 0;  i < NUM_HIGHLIGHTS;  i++)
+            if (n == 0 || i == n-1)
+                clear_pattern(&hl_infos[i]);
+    } else
+    {
+        if (n == 0)
+        {
+            for (i = 0;  i < NUM_HIGHLIGHTS;  i++)
+                if (!prev_pattern(&hl_infos[i]))
+                    break;
+            if (i == NUM_HIGHLIGHTS)
+            {
+                parg.p_int = NUM_HIGHLIGHTS;
+                error("All %d highlights are in use", &parg);
+                return;
+            }
+            n = i + 1;
+        }
+        /*
+         * Only regular expressions apply to a highlight.
+         * It keeps its own caselessness, and does not
+         * change that of searches.
+         */
+        if (set_pattern(&hl_infos[n-1], pattern, search_type & SRCH_NO_REGEX, 1) < 0)
+            return;
+    }
+
+    /*
+     * Gather the strings of all the highlight patterns
+     * into one automaton.
+     */
+    uncompile_litset(&hl_litset);
+    hl_count = nlits = 0;
+    for (i = 0;  i < NUM_HIGHLIGHTS;  i++)
+    {
+        hl_litbit[i] = -1;
+        if (!prev_pattern(&hl_infos[i]))
+            continue;
+        hl_count++;
+        if (hl_infos[i].literal != NULL)
+        {
+            hl_litbit[i] = nlits;
+            lits[nlits++] = hl_infos[i].literal;
+        }
+    }
+    if (nlits > 0)
+        hl_litset = compile_litset(lits, nlits);
+    clr_hilite();
+    screen_trashed = 1;
+}
+
+/*
+ * Are any highlight patterns in use?
+ */
+    public int
+is_highlighting(VOID_PARAM)
+{
+    if (ch_getflags() & CH_HELPFILE)
+        return (0);
+    return (hl_count > 0);
+}
+
 /*
  * Is there a line filter in effect?
  */
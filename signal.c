@@ -267,6 +267,7 @@ psignals(VOID_PARAM)
             calc_jump_sline();
             calc_shift_count();
         }
+        scr_forget();
         screen_trashed = 1;
     }
 #endif
@@ -188,7 +188,7 @@ getchr(VOID_PARAM)
 
     do
     {
-        flush();
+        output_done();
 #if MSDOS_COMPILER && MSDOS_COMPILER != DJGPPC
         /*
          * In raw read, we don't see ^C so look here for it.